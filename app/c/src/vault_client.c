@@ -1,5 +1,8 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
 #include <unistd.h>
 #include <curl/curl.h>
@@ -7,6 +10,10 @@
 #include <pthread.h>
 #include <time.h>
 #include <ctype.h> 
+#include <semaphore.h>
+#include <poll.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
 
 // Vault API 버전 상수
 #define VAULT_API_VERSION "v1"
@@ -16,6 +23,14 @@
 #define MAX_URL_SIZE 256
 #define RESPONSE_BUFFER_SIZE 4096 
 #define TOKEN_HEADER_BUF_SIZE 256 
+#define CONFIG_LINE_SIZE 8192
+#define MAX_SECRET_PATHS 512
+#define MAX_SECRET_PATH_LEN 64
+#define MAX_WORKER_THREADS 64
+#define WORK_QUEUE_CAPACITY 1024   // 2의 거듭제곱, MAX_SECRET_PATHS 이상
+#define DISPATCH_TICK_MS 100
+#define AUTH_RETRY_SECONDS 5
+#define FORBIDDEN_RECHECK_SECONDS 60  // lookup-self 로 유효 확인된 토큰은 이 시간 동안 403 에도 재확인하지 않음
 
 // Vault 설정 구조체
 typedef struct {
@@ -24,22 +39,53 @@ typedef struct {
     char role_id[64];
     char secret_id[64];
     char kv_mount_point[32];
-    char kv_secret_path[64];
+    char kv_secret_paths[MAX_SECRET_PATHS][MAX_SECRET_PATH_LEN];
+    int kv_secret_path_count;
     float renewal_threshold_ratio;
     int secret_interval_seconds;
-    int token_ttl_seconds_assumed;
+    int worker_threads;
 } VaultConfig;
 
 // Vault 상태 구조체
 typedef struct {
     char token[128];
-    long current_ttl;
+    long current_ttl;          // 로그인/갱신 응답의 lease_duration (초)
+    long login_ttl;            // 마지막 로그인 시 발급된 TTL (최대 TTL 근접 판단용)
+    long long ttl_received_ms; // current_ttl 을 받은 시각 (CLOCK_MONOTONIC)
+    unsigned long generation;  // 재인증할 때마다 증가
+    unsigned long verified_generation; // lookup-self 로 유효함이 확인된 토큰 세대 (0: 없음)
+    long long verified_at_ms;          // 위 확인 시각 (CLOCK_MONOTONIC)
     int renewable;
     pthread_mutex_t lock;
 } VaultState;
 
+// 경로별 스케줄 상태 (next_due_ms 는 CLOCK_MONOTONIC 기준 밀리초)
+typedef struct {
+    long long next_due_ms;
+    int in_flight;
+} SecretPathState;
+
+// Lock-free MPMC 작업 큐 (bounded ring buffer, 슬롯별 sequence 번호 사용)
+typedef struct {
+    size_t sequence;
+    int path_index;
+} WorkQueueSlot;
+
+typedef struct {
+    WorkQueueSlot slots[WORK_QUEUE_CAPACITY];
+    size_t enqueue_pos;
+    size_t dequeue_pos;
+    sem_t available;
+} WorkQueue;
+
 VaultConfig g_config;
 VaultState g_state;
+SecretPathState g_paths[MAX_SECRET_PATHS];
+WorkQueue g_queue;
+
+// 토큰 매니저 이벤트: 갱신 시점 타이머 / 다른 스레드의 403 재인증 요청
+int g_renewal_timer_fd = -1;
+int g_reauth_event_fd = -1;
 
 // --- 헬퍼 함수 선언 및 구현 ---
 
@@ -70,6 +116,38 @@ void trim_whitespace(char *str) {
     }
 }
 
+// 단조 시계 기준 현재 시각 (밀리초)
+long long monotonic_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+void sleep_ms(long long ms) {
+    struct timespec ts = { ms / 1000, (ms % 1000) * 1000000 };
+    nanosleep(&ts, NULL);
+}
+
+// 쉼표로 구분된 경로 목록을 config->kv_secret_paths 에 추가 (KV_SECRET_PATHS 를 여러 줄 쓰면 이어서 추가)
+void add_secret_paths(VaultConfig *config, char *value) {
+    char *saveptr = NULL;
+    for (char *token = strtok_r(value, ",", &saveptr); token; token = strtok_r(NULL, ",", &saveptr)) {
+        trim_whitespace(token);
+        if (strlen(token) == 0) continue;
+        if (strlen(token) >= MAX_SECRET_PATH_LEN) {
+            // 잘린 경로는 다른(존재하지 않는) 경로가 되므로 조회 대상에서 제외
+            fprintf(stderr, "⚠️ [Config] KV 경로는 최대 %d자까지 지원합니다. 무시: %s\n", MAX_SECRET_PATH_LEN - 1, token);
+            continue;
+        }
+        if (config->kv_secret_path_count >= MAX_SECRET_PATHS) {
+            fprintf(stderr, "⚠️ [Config] KV 경로는 최대 %d개까지 지원합니다. 무시: %s\n", MAX_SECRET_PATHS, token);
+            continue;
+        }
+        strncpy(config->kv_secret_paths[config->kv_secret_path_count], token, MAX_SECRET_PATH_LEN - 1);
+        config->kv_secret_path_count++;
+    }
+}
+
 // ---------------------------------------------------
 // 설정 파일(config.ini)을 읽어 VaultConfig 구조체에 파싱하는 함수
 // ---------------------------------------------------
@@ -80,21 +158,32 @@ int parse_config(VaultConfig *config) {
         return -1;
     }
 
-    char line[256];
+    char line[CONFIG_LINE_SIZE];
     char key[128];
-    char value[128];
+    char value[CONFIG_LINE_SIZE];
     int in_vault_section = 0;
     
     memset(config, 0, sizeof(VaultConfig));
     config->renewal_threshold_ratio = 0.2;
     config->secret_interval_seconds = 10;
-    config->token_ttl_seconds_assumed = 120;
+    config->worker_threads = 4;
 
     while (fgets(line, sizeof(line), file)) {
+        // 버퍼보다 긴 줄은 나뉘어 읽히며 잘린 경로/값이 되므로 설정 오류로 처리
+        if (!strchr(line, '\n')) {
+            int next = fgetc(file);
+            if (next != EOF) {
+                fprintf(stderr, "❌ [Config] 설정 줄이 너무 깁니다 (최대 %d자). KV_SECRET_PATHS 는 여러 줄로 나눠 지정하세요.\n",
+                        CONFIG_LINE_SIZE - 2);
+                fclose(file);
+                return -1;
+            }
+        }
+
         char *comment_pos = strchr(line, '#');
         if (comment_pos) *comment_pos = '\0';
         
-        char temp_line[256];
+        char temp_line[CONFIG_LINE_SIZE];
         strncpy(temp_line, line, sizeof(temp_line) - 1);
         temp_line[sizeof(temp_line) - 1] = '\0';
         trim_whitespace(temp_line);
@@ -121,10 +210,10 @@ int parse_config(VaultConfig *config) {
                 else if (strcmp(key, "ROLE_ID") == 0) strncpy(config->role_id, value, sizeof(config->role_id) - 1);
                 else if (strcmp(key, "SECRET_ID") == 0) strncpy(config->secret_id, value, sizeof(config->secret_id) - 1);
                 else if (strcmp(key, "KV_MOUNT_POINT") == 0) strncpy(config->kv_mount_point, value, sizeof(config->kv_mount_point) - 1);
-                else if (strcmp(key, "KV_SECRET_PATH") == 0) strncpy(config->kv_secret_path, value, sizeof(config->kv_secret_path) - 1);
+                else if (strcmp(key, "KV_SECRET_PATH") == 0 || strcmp(key, "KV_SECRET_PATHS") == 0) add_secret_paths(config, value);
                 else if (strcmp(key, "SECRET_INTERVAL_SECONDS") == 0) config->secret_interval_seconds = atoi(value);
                 else if (strcmp(key, "RENEWAL_THRESHOLD_RATIO") == 0) config->renewal_threshold_ratio = atof(value);
-                else if (strcmp(key, "TOKEN_TTL_SECONDS_ASSUMED") == 0) config->token_ttl_seconds_assumed = atoi(value);
+                else if (strcmp(key, "WORKER_THREADS") == 0) config->worker_threads = atoi(value);
             }
         }
     }
@@ -136,18 +225,83 @@ int parse_config(VaultConfig *config) {
         return -1;
     }
 
+    if (config->worker_threads < 1) config->worker_threads = 1;
+    if (config->worker_threads > MAX_WORKER_THREADS) config->worker_threads = MAX_WORKER_THREADS;
+    if (config->secret_interval_seconds < 1) config->secret_interval_seconds = 1;
+
     return 0;
 }
 
+// ----------------------------------------------------------------
+// 📥 Lock-free 작업 큐
+// ----------------------------------------------------------------
+// 각 슬롯의 sequence 값으로 생산자/소비자가 CAS 만으로 위치를 확보합니다.
+// 경로는 in_flight 플래그로 큐에 최대 1번만 들어가므로 용량 초과가 발생하지 않습니다.
+// 대기 중인 워커는 세마포어(available)로 깨웁니다.
+
+int work_queue_init(WorkQueue *queue) {
+    for (size_t i = 0; i < WORK_QUEUE_CAPACITY; i++) {
+        queue->slots[i].sequence = i;
+    }
+    queue->enqueue_pos = 0;
+    queue->dequeue_pos = 0;
+    return sem_init(&queue->available, 0, 0);
+}
+
+int work_queue_push(WorkQueue *queue, int path_index) {
+    size_t pos = __atomic_load_n(&queue->enqueue_pos, __ATOMIC_RELAXED);
+    for (;;) {
+        WorkQueueSlot *slot = &queue->slots[pos & (WORK_QUEUE_CAPACITY - 1)];
+        size_t seq = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        long diff = (long)seq - (long)pos;
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&queue->enqueue_pos, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                slot->path_index = path_index;
+                __atomic_store_n(&slot->sequence, pos + 1, __ATOMIC_RELEASE);
+                sem_post(&queue->available);
+                return 0;
+            }
+        } else if (diff < 0) {
+            return -1; // 큐 가득 참
+        } else {
+            pos = __atomic_load_n(&queue->enqueue_pos, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+int work_queue_pop(WorkQueue *queue, int *path_index) {
+    size_t pos = __atomic_load_n(&queue->dequeue_pos, __ATOMIC_RELAXED);
+    for (;;) {
+        WorkQueueSlot *slot = &queue->slots[pos & (WORK_QUEUE_CAPACITY - 1)];
+        size_t seq = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        long diff = (long)seq - (long)(pos + 1);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&queue->dequeue_pos, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                *path_index = slot->path_index;
+                __atomic_store_n(&slot->sequence, pos + WORK_QUEUE_CAPACITY, __ATOMIC_RELEASE);
+                return 0;
+            }
+        } else if (diff < 0) {
+            return -1; // 큐 비어 있음
+        } else {
+            pos = __atomic_load_n(&queue->dequeue_pos, __ATOMIC_RELAXED);
+        }
+    }
+}
+
 // --- Vault API 함수 선언 ---
 int vault_authenticate();
-int vault_lookup_token();
 int vault_renew_token();
-int vault_read_secret();
+int vault_lookup_self();
+int vault_read_secret(CURL *curl, const char *secret_path);
+void vault_request_reauth(unsigned long rejected_generation);
 
 // --- 스레드 함수 선언 ---
 void *token_renewal_thread(void *arg);
 void *secret_scheduler_thread(void *arg);
+void *secret_worker_thread(void *arg);
 
 
 // ----------------------------------------------------------------
@@ -193,10 +347,14 @@ int vault_authenticate() {
                     pthread_mutex_lock(&g_state.lock);
                     strncpy(g_state.token, json_string_value(json_object_get(auth, "client_token")), sizeof(g_state.token) - 1);
                     g_state.current_ttl = json_integer_value(json_object_get(auth, "lease_duration"));
+                    g_state.login_ttl = g_state.current_ttl;
+                    g_state.ttl_received_ms = monotonic_ms();
                     g_state.renewable = json_true() == json_object_get(auth, "renewable");
+                    g_state.generation++;
+                    long ttl = g_state.current_ttl;
                     pthread_mutex_unlock(&g_state.lock);
                     success = 0; // 성공
-                    printf("✅ AppRole 인증 성공! TTL: %ld초\n", g_state.current_ttl);
+                    printf("✅ AppRole 인증 성공! TTL: %ld초\n", ttl);
                 }
                 json_decref(root);
             }
@@ -214,14 +372,14 @@ int vault_authenticate() {
     return success;
 }
 
-// 토큰 상태 조회 (GET /v1/auth/token/lookup-self)
-int vault_lookup_token() {
+// 토큰 갱신 (POST /v1/auth/token/renew-self)
+int vault_renew_token() {
     CURL *curl = curl_easy_init();
     if (!curl) return -1;
 
     char url[MAX_URL_SIZE];
-    snprintf(url, MAX_URL_SIZE, "%s/%s/auth/token/lookup-self", g_config.vault_addr, VAULT_API_VERSION);
-    
+    snprintf(url, MAX_URL_SIZE, "%s/%s/auth/token/renew-self", g_config.vault_addr, VAULT_API_VERSION);
+
     char response[RESPONSE_BUFFER_SIZE] = {0};
     long http_code = 0;
     int success = -1;
@@ -238,8 +396,10 @@ int vault_lookup_token() {
         snprintf(namespace_header, 64, "X-Vault-Namespace: %s", g_config.vault_namespace);
         headers = curl_slist_append(headers, namespace_header);
     }
-
+    
+    // POST 요청이지만 payload는 {}로 빈 JSON을 사용
     curl_easy_setopt(curl, CURLOPT_URL, url);
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, "{}");
     curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
     curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, response);
@@ -251,19 +411,19 @@ int vault_lookup_token() {
         if (http_code == 200) {
             json_t *root = json_loads(response, 0, NULL);
             if (root) {
-                json_t *data = json_object_get(root, "data");
-                if (data) {
+                json_t *auth = json_object_get(root, "auth");
+                if (auth) {
                     pthread_mutex_lock(&g_state.lock);
-                    g_state.current_ttl = json_integer_value(json_object_get(data, "ttl"));
-                    g_state.renewable = json_true() == json_object_get(data, "renewable");
+                    g_state.current_ttl = json_integer_value(json_object_get(auth, "lease_duration"));
+                    g_state.ttl_received_ms = monotonic_ms();
+                    g_state.renewable = json_true() == json_object_get(auth, "renewable");
                     pthread_mutex_unlock(&g_state.lock);
                     success = 0;
                 }
                 json_decref(root);
             }
         } else {
-            // 토큰이 유효하지 않으면 403을 반환할 수 있음
-            fprintf(stderr, "❌ 토큰 조회 실패: HTTP %ld\n", http_code);
+            fprintf(stderr, "❌ 토큰 갱신 실패: HTTP %ld. 응답: %s\n", http_code, response);
         }
     } else {
         fprintf(stderr, "❌ cURL 오류: %s\n", curl_easy_strerror(res));
@@ -274,23 +434,25 @@ int vault_lookup_token() {
     return success;
 }
 
-// 토큰 갱신 (POST /v1/auth/token/renew-self)
-int vault_renew_token() {
+// 현재 토큰 유효성 확인 (GET /v1/auth/token/lookup-self)
+// 반환: 200 이면 0 (유효), 403 이면 1 (폐기/만료), 그 외 오류는 -1
+int vault_lookup_self() {
     CURL *curl = curl_easy_init();
     if (!curl) return -1;
 
     char url[MAX_URL_SIZE];
-    snprintf(url, MAX_URL_SIZE, "%s/%s/auth/token/renew-self", g_config.vault_addr, VAULT_API_VERSION);
+    snprintf(url, MAX_URL_SIZE, "%s/%s/auth/token/lookup-self", g_config.vault_addr, VAULT_API_VERSION);
 
     char response[RESPONSE_BUFFER_SIZE] = {0};
     long http_code = 0;
-    int success = -1;
+    int result = -1;
 
     char token_header[TOKEN_HEADER_BUF_SIZE];
+    pthread_mutex_lock(&g_state.lock);
     snprintf(token_header, TOKEN_HEADER_BUF_SIZE, "X-Vault-Token: %s", g_state.token);
-    
+    pthread_mutex_unlock(&g_state.lock);
+
     struct curl_slist *headers = NULL;
-    headers = curl_slist_append(headers, "Content-Type: application/json");
     headers = curl_slist_append(headers, token_header);
 
     if (strlen(g_config.vault_namespace) > 0) {
@@ -298,10 +460,8 @@ int vault_renew_token() {
         snprintf(namespace_header, 64, "X-Vault-Namespace: %s", g_config.vault_namespace);
         headers = curl_slist_append(headers, namespace_header);
     }
-    
-    // POST 요청이지만 payload는 {}로 빈 JSON을 사용
+
     curl_easy_setopt(curl, CURLOPT_URL, url);
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, "{}");
     curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
     curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, response);
@@ -309,21 +469,12 @@ int vault_renew_token() {
     CURLcode res = curl_easy_perform(curl);
     if (res == CURLE_OK) {
         curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-        
         if (http_code == 200) {
-            json_t *root = json_loads(response, 0, NULL);
-            if (root) {
-                json_t *auth = json_object_get(root, "auth");
-                if (auth) {
-                    pthread_mutex_lock(&g_state.lock);
-                    g_state.current_ttl = json_integer_value(json_object_get(auth, "lease_duration"));
-                    pthread_mutex_unlock(&g_state.lock);
-                    success = 0;
-                }
-                json_decref(root);
-            }
+            result = 0;
+        } else if (http_code == 403) {
+            result = 1;
         } else {
-            fprintf(stderr, "❌ 토큰 갱신 실패: HTTP %ld. 응답: %s\n", http_code, response);
+            fprintf(stderr, "❌ 토큰 확인 실패: HTTP %ld. 응답: %s\n", http_code, response);
         }
     } else {
         fprintf(stderr, "❌ cURL 오류: %s\n", curl_easy_strerror(res));
@@ -331,17 +482,17 @@ int vault_renew_token() {
 
     curl_slist_free_all(headers);
     curl_easy_cleanup(curl);
-    return success;
+    return result;
 }
 
 // KV Secret 조회 (GET /v1/<mount_point>/data/<path>)
-int vault_read_secret() {
-    CURL *curl = curl_easy_init();
-    if (!curl) return -1;
+// 워커 스레드가 소유한 cURL 핸들을 재사용하여 연결(keep-alive)을 유지합니다.
+int vault_read_secret(CURL *curl, const char *secret_path) {
+    curl_easy_reset(curl);
 
     char url[MAX_URL_SIZE];
     snprintf(url, MAX_URL_SIZE, "%s/%s/%s/data/%s", 
-             g_config.vault_addr, VAULT_API_VERSION, g_config.kv_mount_point, g_config.kv_secret_path);
+             g_config.vault_addr, VAULT_API_VERSION, g_config.kv_mount_point, secret_path);
 
     printf(">>> 🔎 KV Secret 요청 URL: %s\n", url);
     
@@ -350,7 +501,10 @@ int vault_read_secret() {
     int success = -1;
 
     char token_header[TOKEN_HEADER_BUF_SIZE];
+    pthread_mutex_lock(&g_state.lock);
     snprintf(token_header, TOKEN_HEADER_BUF_SIZE, "X-Vault-Token: %s", g_state.token);
+    unsigned long token_generation = g_state.generation;
+    pthread_mutex_unlock(&g_state.lock);
 
     struct curl_slist *headers = NULL;
     headers = curl_slist_append(headers, token_header);
@@ -392,7 +546,9 @@ int vault_read_secret() {
                             }
                         }
 
-                        printf("✅ KV Secret 데이터 조회 성공: %s/%s", g_config.kv_mount_point, g_config.kv_secret_path);
+                        // 여러 워커의 출력이 섞이지 않도록 stdout 을 잠근 상태로 출력
+                        flockfile(stdout);
+                        printf("✅ KV Secret 데이터 조회 성공: %s/%s", g_config.kv_mount_point, secret_path);
                         
                         // 버전 정보가 유효한 경우에만 (Version: %s) 출력
                         if (strlen(version_str) > 0) {
@@ -404,20 +560,23 @@ int vault_read_secret() {
                         json_object_foreach(secret_data, key, value) {
                             printf("      - %s: %s\n", key, json_string_value(value) ? json_string_value(value) : json_dumps(value, JSON_COMPACT));
                         }
+                        funlockfile(stdout);
                         success = 0;
                     }
                 }
                 json_decref(root);
             }
         } else {
-            fprintf(stderr, "❌ Secret 조회 실패: HTTP %ld. 응답: %s\n", http_code, response);
+            fprintf(stderr, "❌ Secret 조회 실패: %s (HTTP %ld). 응답: %s\n", secret_path, http_code, response);
+            if (http_code == 403) {
+                vault_request_reauth(token_generation);
+            }
         }
     } else {
         fprintf(stderr, "❌ cURL 오류: %s\n", curl_easy_strerror(res));
     }
 
     curl_slist_free_all(headers);
-    curl_easy_cleanup(curl);
     return success;
 }
 
@@ -426,65 +585,222 @@ int vault_read_secret() {
 // 🧵 스케줄링 스레드 구현
 // ----------------------------------------------------------------
 
+// 토큰 세대가 최근 lookup-self 로 유효 확인되었는지 (g_state.lock 보유 상태에서 호출)
+int token_recently_verified(unsigned long token_generation) {
+    return g_state.verified_generation == token_generation &&
+           monotonic_ms() - g_state.verified_at_ms < FORBIDDEN_RECHECK_SECONDS * 1000LL;
+}
+
+// 403 을 받은 스레드가 토큰 매니저에 재인증을 요청 (이미 재인증된 토큰이면 무시)
+// 토큰 매니저는 lookup-self 로 토큰이 실제로 무효인지 확인한 뒤에만 재인증합니다.
+// 최근 유효 확인된 토큰의 403 은 경로 권한 거부이므로 재확인 요청도 보내지 않음
+void vault_request_reauth(unsigned long rejected_generation) {
+    pthread_mutex_lock(&g_state.lock);
+    int skip = (rejected_generation != g_state.generation) || token_recently_verified(rejected_generation);
+    pthread_mutex_unlock(&g_state.lock);
+    if (skip) return;
+
+    uint64_t one = 1;
+    if (write(g_reauth_event_fd, &one, sizeof(one)) != sizeof(one)) {
+        fprintf(stderr, "⚠️ [Token Manager] 재인증 요청 전달 실패.\n");
+    }
+}
+
+// 갱신 타이머를 절대 시각(CLOCK_MONOTONIC)으로 설정. deadline_ms <= 0 이면 해제
+void arm_renewal_timer(long long deadline_ms) {
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    if (deadline_ms > 0) {
+        spec.it_value.tv_sec = deadline_ms / 1000;
+        spec.it_value.tv_nsec = (deadline_ms % 1000) * 1000000;
+    }
+    timerfd_settime(g_renewal_timer_fd, TFD_TIMER_ABSTIME, &spec, NULL);
+}
+
+// 응답으로 받은 TTL 기준 갱신 시점: 수신 시각 + TTL * (1 - RENEWAL_THRESHOLD_RATIO)
+void schedule_token_renewal() {
+    pthread_mutex_lock(&g_state.lock);
+    long ttl = g_state.current_ttl;
+    long long received_ms = g_state.ttl_received_ms;
+    pthread_mutex_unlock(&g_state.lock);
+
+    if (ttl <= 0) {
+        // TTL 0 은 만료되지 않는 토큰 (예: root 토큰) → 403 이벤트만 대기
+        printf("    ➡️ [Token Manager] 만료 없는 토큰. 갱신 타이머 해제.\n");
+        arm_renewal_timer(0);
+        return;
+    }
+
+    long long renew_after_ms = (long long)(ttl * 1000 * (1.0 - g_config.renewal_threshold_ratio));
+    if (renew_after_ms < 1) renew_after_ms = 1;
+    arm_renewal_timer(received_ms + renew_after_ms);
+    printf("    ➡️ [Token Manager] TTL %ld초, %lld초 후 갱신 예정.\n", ttl, renew_after_ms / 1000);
+}
+
+// 재인증. 실패하면 AUTH_RETRY_SECONDS 후 다시 시도하도록 타이머를 설정하고 -1 반환
+int token_reauthenticate() {
+    if (vault_authenticate() == 0) {
+        schedule_token_renewal();
+        return 0;
+    }
+    fprintf(stderr, "❌ [Token Manager] 재인증 실패. %d초 후 재시도.\n", AUTH_RETRY_SECONDS);
+    arm_renewal_timer(monotonic_ms() + AUTH_RETRY_SECONDS * 1000);
+    return -1;
+}
+
+// 토큰 매니저: 갱신 시점 타이머 또는 403 재인증 요청이 있을 때만 깨어남 (lookup-self 폴링 없음)
 void *token_renewal_thread(void *arg) {
-    long threshold_ttl = (long)(g_config.token_ttl_seconds_assumed * g_config.renewal_threshold_ratio);
-    
+    struct pollfd fds[2];
+    fds[0].fd = g_renewal_timer_fd;
+    fds[0].events = POLLIN;
+    fds[1].fd = g_reauth_event_fd;
+    fds[1].events = POLLIN;
+
+    int reauth_pending = 0;
+    schedule_token_renewal();
+
     while (1) {
-        printf("\n⏳ [Token Manager] 토큰 갱신 체크 시작...\n");
-        
-        if (vault_lookup_token() != 0) {
-            fprintf(stderr, "❌ [Token Manager] 토큰 상태 조회 실패. 재인증 시도.\n");
-            vault_authenticate(); 
-            sleep(5);
+        if (poll(fds, 2, -1) < 0) continue;
+
+        uint64_t count;
+        if (fds[1].revents & POLLIN) {
+            if (read(g_reauth_event_fd, &count, sizeof(count)) != sizeof(count)) continue;
+
+            // 여러 워커의 요청이 쌓였어도 이미 확인한 세대면 다시 조회하지 않음
+            pthread_mutex_lock(&g_state.lock);
+            unsigned long checked_generation = g_state.generation;
+            int verified = token_recently_verified(checked_generation);
+            pthread_mutex_unlock(&g_state.lock);
+            if (verified) continue;
+
+            // 정책상 거부된 경로도 403 을 반환하므로 토큰이 유효하면 재인증하지 않음
+            int token_state = vault_lookup_self();
+            if (token_state == 0) {
+                pthread_mutex_lock(&g_state.lock);
+                g_state.verified_generation = checked_generation;
+                g_state.verified_at_ms = monotonic_ms();
+                pthread_mutex_unlock(&g_state.lock);
+                fprintf(stderr, "⚠️ [Token Manager] 403 응답 수신. 토큰은 유효함 (경로 권한 거부) → %d초간 재확인 생략.\n",
+                        FORBIDDEN_RECHECK_SECONDS);
+            } else if (token_state == 1) {
+                fprintf(stderr, "🛑 [Token Manager] 403 응답 수신. 토큰 무효 확인 → 재인증 시도.\n");
+                reauth_pending = (token_reauthenticate() != 0);
+            } else {
+                fprintf(stderr, "⚠️ [Token Manager] 403 응답 수신. 토큰 확인 실패 → 다음 403 에서 재확인.\n");
+            }
             continue;
         }
 
+        if (!(fds[0].revents & POLLIN)) continue;
+        if (read(g_renewal_timer_fd, &count, sizeof(count)) != sizeof(count)) continue;
+
+        printf("\n⏳ [Token Manager] 토큰 갱신 시점 도달.\n");
+
         pthread_mutex_lock(&g_state.lock);
-        long current_ttl = g_state.current_ttl;
         int renewable = g_state.renewable;
+        long login_ttl = g_state.login_ttl;
         pthread_mutex_unlock(&g_state.lock);
 
-        printf("    ➡️ Auth Token 잔여 TTL: %ld초 (임계값: %ld초)\n", current_ttl, threshold_ttl);
+        if (reauth_pending || !renewable) {
+            fprintf(stderr, "🛑 [Token Manager] 토큰 갱신 불가 또는 재인증 대기. 재인증 시도.\n");
+            reauth_pending = (token_reauthenticate() != 0);
+            continue;
+        }
 
-        if (current_ttl <= 0 || !renewable) {
-            fprintf(stderr, "🛑 [Token Manager] 토큰 만료 또는 갱신 불가. 재인증 시도.\n");
-            vault_authenticate();
-        } 
-        else if (current_ttl <= threshold_ttl) {
-            printf("🚨 TTL (%ld초)이 임계값 이하입니다. **토큰 갱신(RENEW) 시도**...\n", current_ttl);
-            if (vault_renew_token() != 0) {
-                fprintf(stderr, "❌ [Token Manager] 토큰 갱신 실패. 재인증 시도.\n");
-                vault_authenticate(); 
-            } else {
-                 printf("✅ TTL 갱신 성공.\n");
-            }
-        } 
-        else {
-            printf("✅ TTL (%ld초) > 임계값. 갱신 불필요.\n", current_ttl);
+        printf("🚨 **토큰 갱신(RENEW) 시도**...\n");
+        if (vault_renew_token() != 0) {
+            fprintf(stderr, "❌ [Token Manager] 토큰 갱신 실패. 재인증 시도.\n");
+            reauth_pending = (token_reauthenticate() != 0);
+            continue;
+        }
+
+        pthread_mutex_lock(&g_state.lock);
+        long renewed_ttl = g_state.current_ttl;
+        pthread_mutex_unlock(&g_state.lock);
+
+        // 최대 TTL 에 가까워지면 Vault 가 짧은 TTL 만 돌려주므로 미리 재인증
+        if (renewed_ttl <= (long)(login_ttl * g_config.renewal_threshold_ratio)) {
+            printf("⚠️ [Token Manager] 갱신 TTL(%ld초)이 최대 TTL에 근접. 재인증 시도.\n", renewed_ttl);
+            reauth_pending = (token_reauthenticate() != 0);
+            continue;
         }
 
-        sleep(5); 
+        printf("✅ TTL 갱신 성공.\n");
+        schedule_token_renewal();
     }
     return NULL;
 }
 
+// 경로별 next_due 를 확인하여 조회 시점이 된 경로를 작업 큐에 넣는 디스패처
 void *secret_scheduler_thread(void *arg) {
+    const long long interval_ms = (long long)g_config.secret_interval_seconds * 1000;
+    const int path_count = g_config.kv_secret_path_count;
+
+    // 최초 조회 시점을 interval 구간에 고르게 분산
+    long long start_ms = monotonic_ms();
+    for (int i = 0; i < path_count; i++) {
+        __atomic_store_n(&g_paths[i].next_due_ms, start_ms + interval_ms * i / path_count, __ATOMIC_RELAXED);
+    }
+
     while (1) {
         pthread_mutex_lock(&g_state.lock);
         int authenticated = (strlen(g_state.token) > 0);
         pthread_mutex_unlock(&g_state.lock);
 
-        if (authenticated) {
-            printf("\n--- ♻️ Secret 조회 스케줄러 실행 ---\n");
-            if (vault_read_secret() != 0) {
-                fprintf(stderr, "❌ [Secret Scheduler] Secret 조회 실패.\n");
-            }
-        } else {
+        if (!authenticated) {
             fprintf(stderr, "🛑 [Secret Scheduler] Vault에 인증되지 않았습니다. 조회 불가.\n");
+            sleep(1);
+            continue;
         }
-        
-        sleep(g_config.secret_interval_seconds); 
+
+        long long now = monotonic_ms();
+        long long wake_at = now + DISPATCH_TICK_MS;
+
+        for (int i = 0; i < path_count; i++) {
+            if (__atomic_load_n(&g_paths[i].in_flight, __ATOMIC_ACQUIRE)) continue;
+
+            long long due = __atomic_load_n(&g_paths[i].next_due_ms, __ATOMIC_RELAXED);
+            if (due <= now) {
+                __atomic_store_n(&g_paths[i].in_flight, 1, __ATOMIC_RELEASE);
+                if (work_queue_push(&g_queue, i) != 0) {
+                    __atomic_store_n(&g_paths[i].in_flight, 0, __ATOMIC_RELEASE);
+                    fprintf(stderr, "⚠️ [Secret Scheduler] 작업 큐가 가득 찼습니다: %s\n", g_config.kv_secret_paths[i]);
+                }
+            } else if (due < wake_at) {
+                wake_at = due;
+            }
+        }
+
+        sleep_ms(wake_at - now);
+    }
+    return NULL;
+}
+
+// 작업 큐에서 경로를 꺼내 조회하고, 다음 조회 시점을 예약하는 워커
+void *secret_worker_thread(void *arg) {
+    const long long interval_ms = (long long)g_config.secret_interval_seconds * 1000;
+    CURL *curl = curl_easy_init();
+    if (!curl) {
+        fprintf(stderr, "❌ [Secret Worker] cURL 초기화 실패.\n");
+        return NULL;
+    }
+
+    while (1) {
+        if (sem_wait(&g_queue.available) != 0) continue;
+
+        int index;
+        if (work_queue_pop(&g_queue, &index) != 0) continue;
+
+        const char *path = g_config.kv_secret_paths[index];
+        if (vault_read_secret(curl, path) != 0) {
+            fprintf(stderr, "❌ [Secret Worker] Secret 조회 실패: %s\n", path);
+        }
+
+        __atomic_store_n(&g_paths[index].next_due_ms, monotonic_ms() + interval_ms, __ATOMIC_RELAXED);
+        __atomic_store_n(&g_paths[index].in_flight, 0, __ATOMIC_RELEASE);
     }
+
+    curl_easy_cleanup(curl);
     return NULL;
 }
 
@@ -501,12 +817,31 @@ int main() {
     printf("--- Vault 클라이언트 초기화 ---\n");
     printf("URL: %s (Namespace: %s)\n", g_config.vault_addr, g_config.vault_namespace);
 
+    if (g_config.kv_secret_path_count == 0) {
+        fprintf(stderr, "❌ [Main] 조회할 KV 경로가 없습니다. KV_SECRET_PATHS를 확인하세요.\n");
+        return 1;
+    }
+
+    if (work_queue_init(&g_queue) != 0) {
+        fprintf(stderr, "❌ [Main] 작업 큐 초기화 실패.\n");
+        return 1;
+    }
+
     // 락 초기화
     if (pthread_mutex_init(&g_state.lock, NULL) != 0) {
         fprintf(stderr, "❌ [Main] Mutex 초기화 실패.\n");
         return 1;
     }
 
+    // 토큰 매니저 이벤트 디스크립터 생성
+    g_renewal_timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    g_reauth_event_fd = eventfd(0, EFD_CLOEXEC);
+    if (g_renewal_timer_fd < 0 || g_reauth_event_fd < 0) {
+        fprintf(stderr, "❌ [Main] timerfd/eventfd 생성 실패.\n");
+        pthread_mutex_destroy(&g_state.lock);
+        return 1;
+    }
+
     // 2. 초기 인증
     if (vault_authenticate() != 0) {
         fprintf(stderr, "❌ [Main] 초기 인증 실패. 종료합니다.\n");
@@ -516,6 +851,7 @@ int main() {
 
     // 3. 스케줄링 스레드 생성
     pthread_t renew_tid, secret_tid;
+    pthread_t worker_tids[MAX_WORKER_THREADS];
 
     if (pthread_create(&renew_tid, NULL, token_renewal_thread, NULL) != 0 ||
         pthread_create(&secret_tid, NULL, secret_scheduler_thread, NULL) != 0) {
@@ -523,11 +859,21 @@ int main() {
         pthread_mutex_destroy(&g_state.lock);
         return 1;
     }
+
+    for (int i = 0; i < g_config.worker_threads; i++) {
+        if (pthread_create(&worker_tids[i], NULL, secret_worker_thread, NULL) != 0) {
+            fprintf(stderr, "❌ [Main] 워커 스레드 생성 실패.\n");
+            pthread_mutex_destroy(&g_state.lock);
+            return 1;
+        }
+    }
     
     // 4. 메인 스레드 무한 대기
     printf("\n⏰ 스케줄러 설정 완료.\n");
-    printf("   - KV Secret 조회/갱신: %d초마다\n", g_config.secret_interval_seconds);
-    printf("   - 토큰 갱신 체크: 5초마다\n");
+    printf("   - KV Secret 조회/갱신: 경로별 %d초마다 (경로 %d개, 워커 %d개)\n",
+           g_config.secret_interval_seconds, g_config.kv_secret_path_count, g_config.worker_threads);
+    printf("   - 토큰 갱신: TTL의 %.0f%% 남았을 때 (timerfd 예약, 403 수신 시 즉시 재인증)\n",
+           g_config.renewal_threshold_ratio * 100);
     printf("\n🚀 메인 스케줄링 루프 시작. Ctrl+C로 종료하세요.\n");
 
     while (1) {
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <sstream>
 #include <map>
@@ -9,6 +10,24 @@
 #include <algorithm>
 #include <iomanip>
 #include <stdexcept>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <utility>
+#include <atomic>
+#include <functional>
+#include <random>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <ctime>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <cerrno>
+#include <cctype>
 
 // JSON 라이브러리
 #include <nlohmann/json.hpp>
@@ -31,6 +50,30 @@ static size_t WriteCallback(void* contents, size_t size, size_t nmemb, void* use
 // =========================================================
 // Configuration Loader
 // =========================================================
+// 테넌트: 네임스페이스 + AppRole 자격 증명 + KV 경로 목록
+struct TenantConfig {
+    std::string id;
+    std::string namespaceId;
+    std::string roleId;
+    std::string secretId;
+    std::string kvMountPath;
+    std::vector<std::string> kvSecretsPaths;
+};
+
+// 렌더링 대상: 테넌트 캐시 → 파일 (template / env / json)
+struct RenderTargetConfig {
+    std::string id;
+    std::string tenantId;
+    std::string format = "template";
+    std::string templateFile;
+    std::string destination;
+    std::vector<std::string> paths;  // env/json 에 포함할 경로 (비어 있으면 테넌트의 전체 경로)
+    mode_t fileMode = 0600;
+    std::string signalPidFile;
+    int signal = SIGHUP;
+    std::string command;
+};
+
 class Config {
 private:
     std::map<std::string, std::string> properties;
@@ -52,24 +95,119 @@ private:
         }
     }
 
+    // 선택 항목: 키가 없으면 기본값 사용
+    double optionalNumber(const std::string& key, double defaultValue) const {
+        const auto it = properties.find(key);
+        if (it == properties.end() || it->second.empty()) return defaultValue;
+        try {
+            return std::stod(it->second);
+        } catch (...) {
+            throw std::runtime_error("❌ Error: 설정 파일의 숫자 값을 파싱할 수 없습니다: " + key);
+        }
+    }
+
+    std::string optionalString(const std::string& key, const std::string& defaultValue) const {
+        const auto it = properties.find(key);
+        return (it == properties.end() || it->second.empty()) ? defaultValue : it->second;
+    }
+
+    static std::vector<std::string> splitList(const std::string& value) {
+        std::vector<std::string> items;
+        std::stringstream ss(value);
+        for (std::string item; std::getline(ss, item, ',');) {
+            item.erase(std::remove_if(item.begin(), item.end(), ::isspace), item.end());
+            if (!item.empty()) items.push_back(item);
+        }
+        return items;
+    }
+
+    // tenants 가 없으면 vault.* 항목으로 단일 테넌트(default) 구성
+    void loadTenants() {
+        const auto tenantIds = splitList(optionalString("tenants", ""));
+        if (tenantIds.empty()) {
+            tenants.push_back(TenantConfig{"default", optionalString("vault.vault_namespace", ""),
+                                           optionalString("vault.vault_role_id", ""), optionalString("vault.vault_secret_id", ""),
+                                           kvMountPath, splitList(optionalString("kv_secrets_paths", ""))});
+            return;
+        }
+
+        for (const auto& id : tenantIds) {
+            const auto prefix = "tenant." + id + ".";
+            TenantConfig tenant{id, optionalString(prefix + "vault_namespace", ""),
+                                optionalString(prefix + "vault_role_id", ""), optionalString(prefix + "vault_secret_id", ""),
+                                optionalString(prefix + "kv_mount_path", kvMountPath),
+                                splitList(optionalString(prefix + "kv_secrets_paths", ""))};
+            if (tenant.roleId.empty() || tenant.secretId.empty())
+                throw std::runtime_error("❌ Error: 테넌트 AppRole 정보가 없습니다: " + id);
+            tenants.push_back(std::move(tenant));
+        }
+    }
+
+    static int parseSignal(const std::string& name) {
+        static const std::map<std::string, int> signals = {
+            {"HUP", SIGHUP}, {"INT", SIGINT}, {"TERM", SIGTERM}, {"USR1", SIGUSR1}, {"USR2", SIGUSR2}};
+        const auto it = signals.find(name.rfind("SIG", 0) == 0 ? name.substr(3) : name);
+        if (it == signals.end()) throw std::runtime_error("❌ Error: 지원하지 않는 시그널입니다: " + name);
+        return it->second;
+    }
+
+    void loadRenderTargets() {
+        for (const auto& id : splitList(optionalString("render_targets", ""))) {
+            const auto prefix = "render." + id + ".";
+            RenderTargetConfig target;
+            target.id = id;
+            target.tenantId = optionalString(prefix + "tenant", tenants.front().id);
+            target.format = optionalString(prefix + "format", target.format);
+            target.templateFile = optionalString(prefix + "template", "");
+            target.destination = optionalString(prefix + "destination", "");
+            target.paths = splitList(optionalString(prefix + "paths", ""));
+            target.signalPidFile = optionalString(prefix + "signal_pid_file", "");
+            target.signal = parseSignal(optionalString(prefix + "signal", "HUP"));
+            target.command = optionalString(prefix + "command", "");
+            try {
+                target.fileMode = static_cast<mode_t>(std::stoul(optionalString(prefix + "file_mode", "0600"), nullptr, 8));
+            } catch (...) {
+                throw std::runtime_error("❌ Error: file_mode 는 8진수여야 합니다: " + id);
+            }
+
+            if (target.format != "template" && target.format != "env" && target.format != "json")
+                throw std::runtime_error("❌ Error: 지원하지 않는 렌더링 형식입니다: " + id + " (" + target.format + ")");
+            if (target.destination.empty() || (target.format == "template" && target.templateFile.empty()))
+                throw std::runtime_error("❌ Error: 렌더링 대상의 destination/template 이 없습니다: " + id);
+            renderTargets.push_back(std::move(target));
+        }
+    }
+
 public:
     std::string vaultAddr;
-    std::string namespaceId;
-    std::string roleId;
-    std::string secretId;
-    std::vector<std::string> kvSecretsPaths;
-    std::string kvMountPath = "kv";
+    std::string kvMountPath = "kv";  // 테넌트별 kv_mount_path 가 없을 때의 기본값
+    std::vector<TenantConfig> tenants;
+    std::vector<RenderTargetConfig> renderTargets;
     long kvRenewalIntervalSeconds = 10;
     double tokenRenewalThresholdPercent = 20.0;
 
+    // 요청 속도 제한 / 백오프 / 서킷 브레이커
+    double rateLimitRequestsPerSecond = 20.0;
+    double rateLimitBurst = 40.0;
+    long backoffBaseMs = 500;
+    long backoffMaxMs = 60000;
+    long circuitBreakerFailureThreshold = 5;
+    long circuitBreakerOpenSeconds = 30;
+
+    // 요청 트레이싱 / 느린 호출 로그
+    bool traceEnabled = false;
+    std::string traceFile = "vault_trace.json";
+    long traceMaxFileBytes = 10 * 1024 * 1024;
+    long traceMaxFiles = 5;
+    bool slowCallLogEnabled = false;  // trace_enabled 와 별개로 느린 호출 로그만 켤 수 있음
+    long slowCallThresholdMs = 500;
+    std::string slowCallLogFile = "vault_slow_calls.log";
+
     explicit Config(const std::string& filename = "config.properties") {
         std::cout << "⏳ 설정 파일 로드 중: " << filename << std::endl;
         loadFile(filename);
 
         vaultAddr = properties["vault.vault_addr"];
-        namespaceId = properties["vault.vault_namespace"];
-        roleId = properties["vault.vault_role_id"];
-        secretId = properties["vault.vault_secret_id"];
         if (properties.count("kv_mount_path")) kvMountPath = properties["kv_mount_path"];
 
         try {
@@ -79,75 +217,500 @@ public:
             throw std::runtime_error("❌ Error: 설정 파일의 숫자 값을 파싱할 수 없습니다.");
         }
 
-        std::stringstream ss(properties["kv_secrets_paths"]);
-        for (std::string path; std::getline(ss, path, ',');) {
-            path.erase(std::remove_if(path.begin(), path.end(), ::isspace), path.end());
-            if (!path.empty()) kvSecretsPaths.push_back(path);
+        rateLimitRequestsPerSecond = optionalNumber("rate_limit_requests_per_second", rateLimitRequestsPerSecond);
+        rateLimitBurst = std::max(1.0, optionalNumber("rate_limit_burst", rateLimitBurst));
+        backoffBaseMs = static_cast<long>(optionalNumber("backoff_base_ms", backoffBaseMs));
+        backoffMaxMs = static_cast<long>(optionalNumber("backoff_max_ms", backoffMaxMs));
+        circuitBreakerFailureThreshold = static_cast<long>(optionalNumber("circuit_breaker_failure_threshold", circuitBreakerFailureThreshold));
+        circuitBreakerOpenSeconds = static_cast<long>(optionalNumber("circuit_breaker_open_seconds", circuitBreakerOpenSeconds));
+        traceEnabled = optionalNumber("trace_enabled", 0) != 0;
+        traceFile = optionalString("trace_file", traceFile);
+        traceMaxFileBytes = static_cast<long>(optionalNumber("trace_max_file_bytes", traceMaxFileBytes));
+        traceMaxFiles = std::max(1L, static_cast<long>(optionalNumber("trace_max_files", traceMaxFiles)));
+        slowCallLogEnabled = optionalNumber("slow_call_log_enabled", 0) != 0;
+        slowCallThresholdMs = static_cast<long>(optionalNumber("slow_call_threshold_ms", slowCallThresholdMs));
+        slowCallLogFile = optionalString("slow_call_log_file", slowCallLogFile);
+
+        loadTenants();
+        loadRenderTargets();
+
+        std::cout << "✅ 설정 파일 로드 완료. Vault Addr: " << vaultAddr << ", 테넌트: " << tenants.size() << "개" << std::endl;
+    }
+};
+
+// =========================================================
+// Request Control (Rate Limit / Backoff / Circuit Breaker)
+// =========================================================
+// 요청 우선순위: 로그인/토큰 갱신(Auth)이 대량 KV 조회(Bulk)보다 먼저 처리됩니다.
+enum class RequestPriority { Auth, Bulk };
+
+// 재시도 가치가 있는 실패: 전송 오류(0), 429, 5xx
+static bool isRetryableStatus(long httpCode) {
+    return httpCode == 0 || httpCode == 429 || httpCode >= 500;
+}
+
+// ---------------------------------------------------------
+// Token Bucket 속도 제한 (모든 스레드가 공유)
+// ---------------------------------------------------------
+// Auth 요청이 대기 중이면 Bulk 요청은 토큰을 가져가지 못하고,
+// Bulk 는 버킷의 일부(authReserve)를 항상 Auth 몫으로 남겨 둡니다.
+class RateLimiter {
+private:
+    const double ratePerSecond;
+    const double capacity;
+    const double authReserve;
+    double tokens;
+    steady_clock::time_point lastRefill = steady_clock::now();
+    int authWaiting = 0;
+    std::mutex mutex;
+    std::condition_variable tokensAvailable;
+
+    void refill() {
+        const auto now = steady_clock::now();
+        const double elapsed = duration<double>(now - lastRefill).count();
+        tokens = std::min(capacity, tokens + elapsed * ratePerSecond);
+        lastRefill = now;
+    }
+
+public:
+    RateLimiter(double requestsPerSecond, double burst)
+        : ratePerSecond(requestsPerSecond), capacity(burst),
+          authReserve(std::min(burst - 1.0, std::max(1.0, burst * 0.1))), tokens(burst) {}
+
+    void acquire(RequestPriority priority) {
+        if (ratePerSecond <= 0) return;  // 0 이하: 제한 없음
+
+        std::unique_lock<std::mutex> lock(mutex);
+        const bool isAuth = priority == RequestPriority::Auth;
+        if (isAuth) authWaiting++;
+
+        while (true) {
+            refill();
+            const double floor = isAuth ? 0.0 : authReserve;
+            if ((isAuth || authWaiting == 0) && tokens - floor >= 1.0) {
+                tokens -= 1.0;
+                break;
+            }
+            const double missing = std::max(0.0, 1.0 + floor - tokens);
+            const auto wait = duration_cast<microseconds>(duration<double>(missing / ratePerSecond));
+            tokensAvailable.wait_for(lock, std::max(wait, microseconds(1000)));
         }
 
-        std::cout << "✅ 설정 파일 로드 완료. Vault Addr: " << vaultAddr << std::endl;
+        if (isAuth && --authWaiting == 0) tokensAvailable.notify_all();
+    }
+};
+
+// ---------------------------------------------------------
+// Decorrelated Jitter 지수 백오프
+// ---------------------------------------------------------
+// sleep = min(cap, random(base, prev * 3))
+class DecorrelatedJitterBackoff {
+private:
+    long baseMs;
+    long capMs;
+    long previousMs;
+    std::mt19937 rng{std::random_device{}()};
+
+public:
+    DecorrelatedJitterBackoff(long base, long cap) : baseMs(std::max(1L, base)), capMs(std::max(base, cap)), previousMs(baseMs) {}
+
+    milliseconds next() {
+        std::uniform_int_distribution<long> dist(baseMs, std::max(baseMs, previousMs * 3));
+        previousMs = std::min(capMs, dist(rng));
+        return milliseconds(previousMs);
+    }
+
+    void reset() { previousMs = baseMs; }
+};
+
+// ---------------------------------------------------------
+// Circuit Breaker (응답 코드 기반, 테넌트별)
+// ---------------------------------------------------------
+// Closed → 연속 실패 threshold 회 → Open (openDuration 동안 요청 차단)
+// → HalfOpen (시험 요청 1건) → 성공 시 Closed, 실패 시 다시 Open
+class CircuitBreaker {
+private:
+    enum class State { Closed, Open, HalfOpen };
+
+    const std::string name;
+    const long failureThreshold;
+    const seconds openDuration;
+    State state = State::Closed;
+    long consecutiveFailures = 0;
+    bool probeInFlight = false;
+    steady_clock::time_point openUntil;
+    std::mutex mutex;
+
+    void open() {
+        state = State::Open;
+        probeInFlight = false;
+        openUntil = steady_clock::now() + openDuration;
+        std::cerr << "🚧 [" << name << "] 서킷 브레이커 OPEN: " << openDuration.count() << "초 동안 Vault 요청 차단" << std::endl;
+    }
+
+public:
+    CircuitBreaker(const std::string& breakerName, long threshold, long openSeconds)
+        : name(breakerName), failureThreshold(std::max(1L, threshold)), openDuration(openSeconds) {}
+
+    const std::string& tenantName() const { return name; }
+
+    bool allowRequest() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (state == State::Closed) return true;
+        if (state == State::Open) {
+            if (steady_clock::now() < openUntil) return false;
+            state = State::HalfOpen;
+        }
+        if (probeInFlight) return false;
+        probeInFlight = true;
+        return true;
+    }
+
+    void recordResult(long httpCode) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!isRetryableStatus(httpCode)) {
+            if (state != State::Closed)
+                std::cout << "✅ [" << name << "] 서킷 브레이커 CLOSED: Vault 응답 정상화" << std::endl;
+            state = State::Closed;
+            consecutiveFailures = 0;
+            probeInFlight = false;
+            return;
+        }
+        if (state == State::HalfOpen || ++consecutiveFailures >= failureThreshold) {
+            consecutiveFailures = 0;
+            open();
+        }
+    }
+};
+
+// 테넌트별 요청 제어: 속도 제한은 프로세스 전체가 공유하고, 서킷 브레이커는 테넌트마다 둡니다.
+// (한 테넌트의 5xx/전송 오류가 다른 테넌트의 조회와 토큰 갱신을 막지 않도록)
+struct RequestControl {
+    RateLimiter& limiter;
+    CircuitBreaker breaker;
+
+    RequestControl(const Config& config, RateLimiter& sharedLimiter, const std::string& tenantId)
+        : limiter(sharedLimiter),
+          breaker(tenantId, config.circuitBreakerFailureThreshold, config.circuitBreakerOpenSeconds) {}
+
+    // 요청 가능 여부 확인 후 속도 제한 토큰 획득. 서킷이 열려 있으면 false
+    bool admit(RequestPriority priority) {
+        if (!breaker.allowRequest()) return false;
+        limiter.acquire(priority);
+        return true;
     }
 };
 
 // =========================================================
-// Vault Client
+// Request Tracing
 // =========================================================
-class VaultClient {
+// 요청별 단계 시간(DNS/TCP 연결/TLS/Vault 서버 처리/전송)과 파싱 시간을
+// Chrome Trace Event 형식(JSON 배열, chrome://tracing 또는 Perfetto 에서 열람)으로 기록합니다.
+// 파일이 trace_max_file_bytes 를 넘거나 시작 시 이전 실행의 파일이 있으면 trace.json → trace.json.1 → ... 순으로
+// 회전합니다. slow_call_log_enabled 이면 (trace_enabled 와 무관하게) slow_call_threshold_ms 이상 걸린 호출을
+// 별도 로그에 한 줄씩 남깁니다.
+
+// cURL getinfo 기반 단계별 누적 시간 (요청 시작 기준, 마이크로초)
+struct CallTiming {
+    long long startUs = 0;
+    long long nameLookupUs = 0;
+    long long connectUs = 0;
+    long long appConnectUs = 0;
+    long long startTransferUs = 0;
+    long long totalUs = 0;
+    long long bytes = 0;
+    long httpCode = 0;
+};
+
+class RequestTracer {
 private:
-    Config config;
-    std::string currentToken;
-    long leaseDurationSeconds = 0;
-    long authTimeEpochSeconds = 0;
-    bool isRenewable = false;
-    std::map<std::string, std::map<std::string, std::string>> secretsCache;
+    const Config& config;
+    const steady_clock::time_point origin = steady_clock::now();
+    const int pid = static_cast<int>(getpid());
+    std::mutex mutex;
+    std::ofstream traceFile;
+    std::ofstream slowLog;
+    long long writtenBytes = 0;
+
+    static int threadId() {
+        return static_cast<int>(std::hash<std::thread::id>{}(std::this_thread::get_id()) % 100000);
+    }
+
+    static std::string escape(const std::string& value) {
+        std::string out;
+        out.reserve(value.size());
+        for (const char c : value) {
+            if (c == '"' || c == '\\') out.push_back('\\');
+            out.push_back(c);
+        }
+        return out;
+    }
+
+    static std::string ms(long long us) {
+        std::ostringstream os;
+        os << std::fixed << std::setprecision(3) << us / 1000.0;
+        return os.str();
+    }
+
+    // mutex 를 잡은 상태에서 호출
+    void openTraceFile() {
+        traceFile.open(config.traceFile, std::ios::out | std::ios::trunc);
+        traceFile << "[\n";
+        writtenBytes = 2;
+    }
+
+    // trace.json → trace.json.1 → ... (가장 오래된 파일 삭제)
+    void rotateFiles() {
+        const auto& base = config.traceFile;
+        std::remove((base + "." + std::to_string(config.traceMaxFiles)).c_str());
+        for (long i = config.traceMaxFiles - 1; i >= 1; --i)
+            std::rename((base + "." + std::to_string(i)).c_str(), (base + "." + std::to_string(i + 1)).c_str());
+        std::rename(base.c_str(), (base + ".1").c_str());
+    }
+
+    // mutex 를 잡은 상태에서 호출
+    void rotateIfNeeded() {
+        if (writtenBytes < config.traceMaxFileBytes) return;
+
+        traceFile.close();
+        rotateFiles();
+        openTraceFile();
+    }
+
+    // mutex 를 잡은 상태에서 호출 ("ph":"X" complete event)
+    void writeSpan(const std::string& name, const char* category, long long startUs, long long durationUs,
+                   const std::string& args) {
+        std::ostringstream os;
+        os << "{\"name\":\"" << escape(name) << "\",\"cat\":\"" << category << "\",\"ph\":\"X\",\"ts\":" << startUs
+           << ",\"dur\":" << std::max(0LL, durationUs) << ",\"pid\":" << pid << ",\"tid\":" << threadId();
+        if (!args.empty()) os << ",\"args\":{" << args << "}";
+        os << "},\n";
+        const auto line = os.str();
+        traceFile << line;
+        writtenBytes += static_cast<long long>(line.size());
+    }
+
+    // mutex 를 잡은 상태에서 호출
+    void writeSlowCall(const std::string& name, const CallTiming& t) {
+        const auto now = system_clock::to_time_t(system_clock::now());
+        std::tm local{};
+        localtime_r(&now, &local);
+        const auto connectEnd = std::max(t.connectUs, t.appConnectUs);
+        slowLog << std::put_time(&local, "%Y-%m-%d %H:%M:%S") << " SLOW " << ms(t.totalUs) << "ms " << name
+                << " http=" << t.httpCode << " bytes=" << t.bytes
+                << " dns=" << ms(t.nameLookupUs) << " connect=" << ms(t.connectUs - t.nameLookupUs)
+                << " tls=" << ms(t.appConnectUs > 0 ? t.appConnectUs - t.connectUs : 0)
+                << " server=" << ms(t.startTransferUs - connectEnd)
+                << " transfer=" << ms(t.totalUs - t.startTransferUs) << std::endl;
+        std::cerr << "🐢 느린 Vault 호출: " << name << " " << ms(t.totalUs) << "ms (상세: "
+                  << config.slowCallLogFile << ")" << std::endl;
+    }
+
+public:
+    explicit RequestTracer(const Config& cfg) : config(cfg) {
+        if (config.traceEnabled) {
+            // 이전 실행의 트레이스는 덮어쓰지 않고 회전
+            if (::access(config.traceFile.c_str(), F_OK) == 0) rotateFiles();
+            openTraceFile();
+        }
+        if (config.slowCallLogEnabled)
+            slowLog.open(config.slowCallLogFile, std::ios::out | std::ios::app);
+    }
+
+    // span 트레이스 기록 여부
+    bool enabled() const { return config.traceEnabled; }
+
+    // HTTP 호출 단계 시간 수집 여부 (트레이스 또는 느린 호출 로그)
+    bool timingEnabled() const { return config.traceEnabled || config.slowCallLogEnabled; }
+
+    long long nowUs() const {
+        return duration_cast<microseconds>(steady_clock::now() - origin).count();
+    }
+
+    // HTTP 호출 1건: 전체 span 과 단계별 하위 span, 임계값 초과 시 느린 호출 로그
+    // (느린 호출 로그만 켠 경우 임계값 미만 호출은 문자열을 만들지 않음)
+    void recordCall(const char* method, const std::string& url, const CallTiming& t) {
+        const bool slow = config.slowCallLogEnabled && t.totalUs >= config.slowCallThresholdMs * 1000;
+        if (!enabled() && !slow) return;
+
+        const auto path = url.compare(0, config.vaultAddr.size(), config.vaultAddr) == 0
+                              ? url.substr(config.vaultAddr.size()) : url;
+        const auto name = method + path;
+        std::lock_guard<std::mutex> lock(mutex);
+        if (slow) writeSlowCall(name, t);
+        if (!enabled()) return;
+
+        const auto connectEnd = std::max(t.connectUs, t.appConnectUs);
+        std::ostringstream args;
+        args << "\"http\":" << t.httpCode << ",\"bytes\":" << t.bytes
+             << ",\"namelookup_ms\":" << ms(t.nameLookupUs) << ",\"connect_ms\":" << ms(t.connectUs)
+             << ",\"appconnect_ms\":" << ms(t.appConnectUs) << ",\"starttransfer_ms\":" << ms(t.startTransferUs)
+             << ",\"total_ms\":" << ms(t.totalUs);
+
+        rotateIfNeeded();
+        writeSpan(name, "http", t.startUs, t.totalUs, args.str());
+        if (t.nameLookupUs > 0)
+            writeSpan("dns", "http.phase", t.startUs, t.nameLookupUs, "");
+        if (t.connectUs > t.nameLookupUs)
+            writeSpan("tcp_connect", "http.phase", t.startUs + t.nameLookupUs, t.connectUs - t.nameLookupUs, "");
+        if (t.appConnectUs > t.connectUs)
+            writeSpan("tls_handshake", "http.phase", t.startUs + t.connectUs, t.appConnectUs - t.connectUs, "");
+        if (t.startTransferUs > connectEnd)
+            writeSpan("vault_server", "http.phase", t.startUs + connectEnd, t.startTransferUs - connectEnd, "");
+        if (t.totalUs > t.startTransferUs)
+            writeSpan("transfer", "http.phase", t.startUs + t.startTransferUs, t.totalUs - t.startTransferUs, "");
+        traceFile.flush();
+    }
+
+    // JSON 파싱, 갱신 주기 등 임의 구간
+    void recordSpan(const std::string& name, const char* category, long long startUs, long long durationUs,
+                    const std::string& args = "") {
+        if (!enabled()) return;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        rotateIfNeeded();
+        writeSpan(name, category, startUs, durationUs, args);
+        traceFile.flush();
+    }
+};
+
+// =========================================================
+// HTTP Transport
+// =========================================================
+// 모든 cURL 핸들이 공유하는 연결 풀 (연결 캐시, DNS 캐시, TLS 세션).
+// 테넌트 수와 무관하게 Vault 로의 연결을 재사용합니다.
+class SharedConnectionPool {
+private:
+    CURLSH* share = nullptr;
+    std::mutex locks[CURL_LOCK_DATA_LAST];
+
+    static void lockData(CURL*, curl_lock_data data, curl_lock_access, void* userptr) {
+        static_cast<SharedConnectionPool*>(userptr)->locks[data].lock();
+    }
+
+    static void unlockData(CURL*, curl_lock_data data, void* userptr) {
+        static_cast<SharedConnectionPool*>(userptr)->locks[data].unlock();
+    }
+
+public:
+    SharedConnectionPool() {
+        share = curl_share_init();
+        if (!share) throw std::runtime_error("❌ cURL 공유 핸들 초기화 실패.");
+        curl_share_setopt(share, CURLSHOPT_LOCKFUNC, lockData);
+        curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, unlockData);
+        curl_share_setopt(share, CURLSHOPT_USERDATA, this);
+        curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+        curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    }
+
+    ~SharedConnectionPool() {
+        if (share) curl_share_cleanup(share);
+    }
+
+    SharedConnectionPool(const SharedConnectionPool&) = delete;
+    SharedConnectionPool& operator=(const SharedConnectionPool&) = delete;
+
+    CURLSH* handle() const { return share; }
+};
+
+// cURL easy 핸들은 스레드 간 공유할 수 없으므로 스레드마다 VaultHttp 를 하나씩 둡니다.
+// 모든 요청은 호출한 테넌트의 RequestControl(서킷 브레이커 → 속도 제한)을 거칩니다.
+class VaultHttp {
+private:
+    const Config& config;
+    RequestTracer& tracer;
     CURL* curl = nullptr;
 
+public:
+    VaultHttp(const Config& cfg, RequestTracer& requestTracer, SharedConnectionPool& connectionPool)
+        : config(cfg), tracer(requestTracer) {
+        curl = curl_easy_init();
+        if (!curl) throw std::runtime_error("❌ cURL 초기화 실패.");
+        curl_easy_setopt(curl, CURLOPT_SHARE, connectionPool.handle());
+    }
+
+    ~VaultHttp() {
+        if (curl) curl_easy_cleanup(curl);
+    }
+
+    VaultHttp(const VaultHttp&) = delete;
+    VaultHttp& operator=(const VaultHttp&) = delete;
+
+    // 요청 헤더 목록 생성 (호출자가 curl_slist_free_all 로 해제)
+    static curl_slist* buildHeaders(const std::string& namespaceId, const std::string& token, bool jsonBody) {
+        struct curl_slist* headers = nullptr;
+        if (jsonBody)
+            headers = curl_slist_append(headers, "Content-Type: application/json");
+        if (!namespaceId.empty())
+            headers = curl_slist_append(headers, ("X-Vault-Namespace: " + namespaceId).c_str());
+        if (!token.empty())
+            headers = curl_slist_append(headers, ("X-Vault-Token: " + token).c_str());
+        return headers;
+    }
+
     // ---------------------------------------------------------
     // HTTP POST
     // ---------------------------------------------------------
-    long executePost(const std::string& url, const std::string& payload, const std::string& token, std::string& response) {
+    long executePost(RequestControl& control, const std::string& url, const std::string& payload,
+                     const std::string& namespaceId, const std::string& token, std::string& response,
+                     RequestPriority priority = RequestPriority::Auth) {
+        if (!control.admit(priority)) {
+            std::cerr << "🚧 [" << control.breaker.tenantName() << "] 서킷 OPEN: 요청 생략 → " << url << std::endl;
+            return 0;
+        }
+
         curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
         curl_easy_setopt(curl, CURLOPT_POSTFIELDS, payload.c_str());
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
 
-        struct curl_slist* headers = nullptr;
-        headers = curl_slist_append(headers, "Content-Type: application/json");
-        if (!config.namespaceId.empty())
-            headers = curl_slist_append(headers, ("X-Vault-Namespace: " + config.namespaceId).c_str());
-        if (!token.empty())
-            headers = curl_slist_append(headers, ("X-Vault-Token: " + token).c_str());
+        struct curl_slist* headers = buildHeaders(namespaceId, token, true);
+        const auto httpCode = perform(control, "POST ", url, headers, response);
+        curl_slist_free_all(headers);
+        return httpCode;
+    }
 
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-        CURLcode res = curl_easy_perform(curl);
+    // ---------------------------------------------------------
+    // HTTP GET
+    // ---------------------------------------------------------
+    long executeGet(RequestControl& control, const std::string& url, const std::string& namespaceId,
+                    const std::string& token, std::string& response, RequestPriority priority = RequestPriority::Bulk) {
+        if (!control.admit(priority)) {
+            std::cerr << "🚧 [" << control.breaker.tenantName() << "] 서킷 OPEN: 요청 생략 → " << url << std::endl;
+            return 0;
+        }
 
-        long httpCode = 0;
-        if (res == CURLE_OK)
-            curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &httpCode);
-        else
-            std::cerr << "❌ CURL Error: " << curl_easy_strerror(res) << std::endl;
+        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+        curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
 
+        struct curl_slist* headers = buildHeaders(namespaceId, token, false);
+        const auto httpCode = perform(control, "GET ", url, headers, response);
         curl_slist_free_all(headers);
         return httpCode;
     }
 
     // ---------------------------------------------------------
-    // HTTP GET
+    // HTTP GET (미리 만들어 둔 URL/헤더 사용, 요청마다 문자열/헤더를 만들지 않음)
     // ---------------------------------------------------------
-    long executeGet(const std::string& url, const std::string& token, std::string& response) {
+    long executeGet(RequestControl& control, const std::string& url, curl_slist* headers, std::string& response,
+                    RequestPriority priority = RequestPriority::Bulk) {
+        if (!control.admit(priority)) {
+            std::cerr << "🚧 [" << control.breaker.tenantName() << "] 서킷 OPEN: 요청 생략 → " << url << std::endl;
+            return 0;
+        }
+
         curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
         curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
+        return perform(control, "GET ", url, headers, response);
+    }
+
+private:
+    long perform(RequestControl& control, const char* method, const std::string& url, curl_slist* headers,
+                 std::string& response) {
         curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
         curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-
-        struct curl_slist* headers = nullptr;
-        if (!config.namespaceId.empty())
-            headers = curl_slist_append(headers, ("X-Vault-Namespace: " + config.namespaceId).c_str());
-        if (!token.empty())
-            headers = curl_slist_append(headers, ("X-Vault-Token: " + token).c_str());
-
         curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
 
+        const auto startUs = tracer.timingEnabled() ? tracer.nowUs() : 0;
         CURLcode res = curl_easy_perform(curl);
         long httpCode = 0;
         if (res == CURLE_OK)
@@ -155,157 +718,1119 @@ private:
         else
             std::cerr << "❌ CURL Error: " << curl_easy_strerror(res) << std::endl;
 
-        curl_slist_free_all(headers);
+        control.breaker.recordResult(httpCode);
+        if (tracer.timingEnabled()) traceCall(method, url, startUs, httpCode);
         return httpCode;
     }
 
+    void traceCall(const char* method, const std::string& url, long long startUs, long httpCode) {
+        CallTiming timing;
+        timing.startUs = startUs;
+        timing.httpCode = httpCode;
+        curl_off_t value = 0;
+        if (curl_easy_getinfo(curl, CURLINFO_NAMELOOKUP_TIME_T, &value) == CURLE_OK) timing.nameLookupUs = value;
+        if (curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME_T, &value) == CURLE_OK) timing.connectUs = value;
+        if (curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME_T, &value) == CURLE_OK) timing.appConnectUs = value;
+        if (curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME_T, &value) == CURLE_OK) timing.startTransferUs = value;
+        if (curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME_T, &value) == CURLE_OK) timing.totalUs = value;
+        if (curl_easy_getinfo(curl, CURLINFO_SIZE_DOWNLOAD_T, &value) == CURLE_OK) timing.bytes = value;
+        tracer.recordCall(method, url, timing);
+    }
+};
+
+// =========================================================
+// Prepared Requests / Response Buffers
+// =========================================================
+// 정상 상태(steady-state) 갱신 경로에서 힙 할당을 없애기 위한 재사용 객체들입니다.
+
+// 경로별 KV 조회 요청: URL 과 헤더 목록을 한 번만 만들고, 헤더는 토큰이 교체될 때만 다시 만듭니다.
+class PreparedRequest {
+private:
+    const TenantConfig* tenant;
+    std::string secretPath;
+    std::string requestUrl;
+    curl_slist* headers = nullptr;
+    std::shared_ptr<const std::string> headerToken;
+
+public:
+    PreparedRequest(const Config& config, const TenantConfig& tenantConfig, const std::string& path)
+        : tenant(&tenantConfig), secretPath(path),
+          requestUrl(config.vaultAddr + "/v1/" + tenantConfig.kvMountPath + "/data/" + path) {}
+
+    ~PreparedRequest() {
+        if (headers) curl_slist_free_all(headers);
+    }
+
+    PreparedRequest(PreparedRequest&& other) noexcept
+        : tenant(other.tenant), secretPath(std::move(other.secretPath)), requestUrl(std::move(other.requestUrl)),
+          headers(std::exchange(other.headers, nullptr)), headerToken(std::move(other.headerToken)) {}
+
+    PreparedRequest(const PreparedRequest&) = delete;
+    PreparedRequest& operator=(const PreparedRequest&) = delete;
+    PreparedRequest& operator=(PreparedRequest&&) = delete;
+
+    const std::string& path() const { return secretPath; }
+    const std::string& url() const { return requestUrl; }
+
+    curl_slist* headersFor(const std::shared_ptr<const std::string>& token) {
+        if (token != headerToken) {
+            if (headers) curl_slist_free_all(headers);
+            headers = VaultHttp::buildHeaders(tenant->namespaceId, *token, false);
+            headerToken = token;
+        }
+        return headers;
+    }
+};
+
+// 응답 버퍼 풀: 반납된 버퍼는 clear() 만 하고 capacity 를 유지하여 다음 요청에서 재사용합니다.
+class ResponseBufferPool {
+private:
+    std::vector<std::string> freeBuffers;
+    std::mutex mutex;
+    static constexpr size_t INITIAL_CAPACITY = 4096;
+
+public:
+    class Lease {
+    private:
+        ResponseBufferPool* pool;
+        std::string buffer;
+
+    public:
+        Lease(ResponseBufferPool& owner, std::string&& buf) : pool(&owner), buffer(std::move(buf)) {}
+        ~Lease() { pool->release(std::move(buffer)); }
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        std::string& get() { return buffer; }
+    };
+
+    explicit ResponseBufferPool(size_t count) {
+        freeBuffers.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            freeBuffers.emplace_back();
+            freeBuffers.back().reserve(INITIAL_CAPACITY);
+        }
+    }
+
+    Lease acquire() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (freeBuffers.empty()) {
+            std::string buffer;
+            buffer.reserve(INITIAL_CAPACITY);
+            return Lease(*this, std::move(buffer));
+        }
+        std::string buffer = std::move(freeBuffers.back());
+        freeBuffers.pop_back();
+        return Lease(*this, std::move(buffer));
+    }
+
+private:
+    void release(std::string&& buffer) {
+        buffer.clear();
+        std::lock_guard<std::mutex> lock(mutex);
+        if (freeBuffers.size() < freeBuffers.capacity())
+            freeBuffers.push_back(std::move(buffer));
+    }
+};
+
+// KV v2 응답에서 data.metadata.version 을 파싱 없이 찾습니다 (할당 없음).
+// 문자열과 중첩 깊이를 추적하며 한 번 훑으므로 응답의 키 순서나 Secret 값 안의
+// 같은 이름의 키("metadata", "version")에 영향받지 않습니다.
+static bool findKvVersion(const std::string& body, long& version) {
+    constexpr int MAX_DEPTH = 8;
+    std::string_view keys[MAX_DEPTH];  // 깊이별 마지막 키 (1: 루트 객체)
+    int depth = 0;
+    const char* p = body.c_str();
+    const char* const end = p + body.size();
+
+    while (p < end) {
+        if (*p == '"') {
+            const char* const start = ++p;
+            while (p < end && *p != '"') p += (*p == '\\') ? 2 : 1;
+            if (p >= end) return false;
+            const std::string_view token(start, static_cast<size_t>(p - start));
+            ++p;
+            while (p < end && std::isspace(static_cast<unsigned char>(*p))) ++p;
+            if (p == end || *p != ':') continue;  // 키가 아닌 문자열 값
+            ++p;
+            if (depth > 0 && depth < MAX_DEPTH) keys[depth] = token;
+            if (depth == 3 && token == "version" && keys[1] == "data" && keys[2] == "metadata") {
+                char* numberEnd = nullptr;
+                version = std::strtol(p, &numberEnd, 10);
+                return numberEnd != p;
+            }
+            continue;
+        }
+        if (*p == '{' || *p == '[') {
+            if (++depth < MAX_DEPTH) keys[depth] = {};
+        } else if (*p == '}' || *p == ']') {
+            --depth;
+        }
+        ++p;
+    }
+    return false;
+}
+
+// =========================================================
+// Tenant Metrics
+// =========================================================
+// 테넌트별 카운터 (토큰 스케줄러 스레드와 Secret 갱신 루프에서 갱신)
+struct TenantMetrics {
+    std::atomic<long> logins{0};
+    std::atomic<long> loginFailures{0};
+    std::atomic<long> renewals{0};
+    std::atomic<long> renewFailures{0};
+    std::atomic<long> forbidden{0};
+    std::atomic<long> kvReads{0};
+    std::atomic<long> kvUpdated{0};
+    std::atomic<long> kvUnchanged{0};
+    std::atomic<long> kvFailures{0};
+    std::atomic<long> lastCycleMs{0};
+};
+
+// =========================================================
+// Token Manager
+// =========================================================
+// HTTP 상태 코드를 함께 전달하는 Vault 요청 실패 (0: 전송 오류 또는 서킷 OPEN 으로 생략)
+struct VaultRequestError : std::runtime_error {
+    long httpCode;
+
+    VaultRequestError(const std::string& message, long code) : std::runtime_error(message), httpCode(code) {}
+};
+
+// 테넌트 하나의 토큰 수명 주기를 관리합니다. 실제 호출은 TokenScheduler 스레드가 수행합니다.
+// - 응답 TTL 의 (100 - token_renewal_threshold_percent)% 시점에 renew-self
+// - 갱신 불가 토큰이거나 최대 TTL 에 도달해 갱신 TTL 이 줄어들면 미리 재로그인
+// - 새 토큰은 lookup-self 로 검증한 뒤에만 currentToken 과 원자적으로 교체
+class TokenManager {
+private:
+    const Config& config;
+    const TenantConfig& tenant;
+    TenantMetrics& metrics;
+    RequestControl& control;
+    DecorrelatedJitterBackoff retryBackoff;
+    std::function<void()> wakeScheduler;
+
+    // std::atomic_load / std::atomic_store 로만 접근 (읽는 쪽은 락 없이 사용)
+    std::shared_ptr<const std::string> currentToken;
+
+    mutable std::mutex stateMutex;
+    long leaseDurationSeconds = 0;
+    long loginLeaseSeconds = 0;
+    // TTL 기준 시각과 다음 작업 시각은 steady_clock (시스템 시계 변경에 영향받지 않음)
+    steady_clock::time_point ttlReceivedAt;
+    bool isRenewable = false;
+    bool loginRequired = false;
+    bool reauthRequested = false;
+    steady_clock::time_point nextActionTime = steady_clock::time_point::max();
+
+    // 403 후 lookup-self 로 유효함이 확인된 토큰 (정책상 거부된 경로) → 재확인 간격 동안 재인증 요청 생략
+    static constexpr seconds forbiddenRecheckInterval{60};
+    std::shared_ptr<const std::string> verifiedToken;
+    steady_clock::time_point verifiedAt;
+    // lookup-self 로 무효가 확인된 토큰 (재인증 성공 전까지 이 테넌트의 조회를 건너뜀)
+    std::shared_ptr<const std::string> deadToken;
+
     // ---------------------------------------------------------
-    // AppRole 인증
+    // AppRole 인증 → 새 토큰 발급 (교체 전 검증 필요)
     // ---------------------------------------------------------
-    void authenticate() {
-        std::cout << "\n🔐 Vault AppRole 인증 중..." << std::endl;
+    json authenticate(VaultHttp& http) {
+        std::cout << "\n🔐 [" << tenant.id << "] Vault AppRole 인증 중..." << std::endl;
         const auto url = config.vaultAddr + "/v1/auth/approle/login";
-        const json payload = {{"role_id", config.roleId}, {"secret_id", config.secretId}};
+        const json payload = {{"role_id", tenant.roleId}, {"secret_id", tenant.secretId}};
         std::string response;
 
-        const auto httpCode = executePost(url, payload.dump(), "", response);
+        const auto httpCode = http.executePost(control, url, payload.dump(), tenant.namespaceId, "", response);
         if (httpCode != 200)
             throw std::runtime_error("AppRole 인증 실패: " + std::to_string(httpCode) + " → " + response.substr(0, 100));
 
-        const auto root = json::parse(response);
-        const auto& auth = root.at("auth");
+        return json::parse(response).at("auth");
+    }
 
-        currentToken = auth.at("client_token").get<std::string>();
-        leaseDurationSeconds = auth.at("lease_duration").get<long>();
-        isRenewable = auth.at("renewable").get<bool>();
-        authTimeEpochSeconds = duration_cast<seconds>(system_clock::now().time_since_epoch()).count();
+    // ---------------------------------------------------------
+    // 토큰 조회 (GET /v1/auth/token/lookup-self)
+    // ---------------------------------------------------------
+    long lookupSelf(VaultHttp& http, const std::string& token) {
+        const auto url = config.vaultAddr + "/v1/auth/token/lookup-self";
+        std::string response;
+        return http.executeGet(control, url, tenant.namespaceId, token, response, RequestPriority::Auth);
+    }
 
-        std::cout << "✅ 인증 성공: TTL=" << leaseDurationSeconds
-                  << "초, Renewable=" << (isRenewable ? "true" : "false") << std::endl;
+    // 새 토큰 검증
+    void validateToken(VaultHttp& http, const std::string& token) {
+        const auto httpCode = lookupSelf(http, token);
+        if (httpCode != 200)
+            throw std::runtime_error("새 토큰 검증 실패: " + std::to_string(httpCode));
+    }
+
+    // 403 을 받은 토큰이 실제로 무효인지 확인 (Vault 는 정책상 거부된 경로에도 403 을 반환)
+    bool confirmTokenRejected(VaultHttp& http, const std::shared_ptr<const std::string>& suspect) {
+        const auto httpCode = lookupSelf(http, *suspect);
+        if (httpCode == 403) {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            deadToken = suspect;
+            std::cerr << "🛑 [" << tenant.id << "] 403 응답 토큰 무효 확인 → 재인증" << std::endl;
+            return true;
+        }
+
+        if (httpCode == 200) {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            verifiedToken = suspect;
+            verifiedAt = steady_clock::now();
+            std::cerr << "⚠️ [" << tenant.id << "] 토큰은 유효함 (경로 권한 거부) → 재인증 생략" << std::endl;
+        } else {
+            std::cerr << "⚠️ [" << tenant.id << "] 토큰 확인 실패 (HTTP " << httpCode << ") → 재인증 생략" << std::endl;
+        }
+        return false;
     }
 
     // ---------------------------------------------------------
-    // 토큰 갱신
+    // 교체된 토큰 폐기 (POST /v1/auth/token/revoke-self)
     // ---------------------------------------------------------
-    void renewToken(long remainingTtl) {
-        if (!isRenewable) {
-            std::cerr << "⚠️ 현재 토큰은 갱신 불가. 재인증 필요." << std::endl;
-            return;
+    // 실패해도 재인증은 성공으로 처리 (토큰은 TTL 만료 시 사라짐)
+    void revokeToken(VaultHttp& http, const std::string& token) {
+        const auto url = config.vaultAddr + "/v1/auth/token/revoke-self";
+        std::string response;
+        const auto httpCode = http.executePost(control, url, "{}", tenant.namespaceId, token, response);
+        if (httpCode != 204 && httpCode != 200)
+            std::cerr << "⚠️ [" << tenant.id << "] 이전 토큰 폐기 실패 (HTTP " << httpCode << ")" << std::endl;
+    }
+
+    // ---------------------------------------------------------
+    // 재인증: 로그인 → 검증 → 원자적 교체 → 이전 토큰 폐기
+    // ---------------------------------------------------------
+    void reauthenticate(VaultHttp& http) {
+        const auto auth = authenticate(http);
+        auto newToken = std::make_shared<const std::string>(auth.at("client_token").get<std::string>());
+        validateToken(http, *newToken);
+
+        std::shared_ptr<const std::string> replaced;
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            replaced = std::atomic_load(&currentToken);
+            // 이미 무효가 확인된 토큰은 폐기할 필요 없음
+            if (replaced == deadToken) replaced.reset();
+            std::atomic_store(&currentToken, std::shared_ptr<const std::string>(std::move(newToken)));
+            leaseDurationSeconds = auth.at("lease_duration").get<long>();
+            loginLeaseSeconds = leaseDurationSeconds;
+            isRenewable = auth.at("renewable").get<bool>();
+            ttlReceivedAt = steady_clock::now();
+            scheduleNextAction();
         }
+        metrics.logins++;
+
+        std::cout << "✅ [" << tenant.id << "] 인증 성공: TTL=" << leaseDurationSeconds
+                  << "초, Renewable=" << (isRenewable ? "true" : "false") << std::endl;
 
-        std::cout << "♻️ 토큰 갱신 시도 (잔여 TTL=" << remainingTtl << "초)" << std::endl;
+        // 교체 이후 이전 토큰으로 진행 중이던 조회가 403 을 받으면 reportForbidden 이 새 토큰 재시도로 처리
+        if (replaced) revokeToken(http, *replaced);
+    }
+
+    // ---------------------------------------------------------
+    // 토큰 갱신
+    // ---------------------------------------------------------
+    void renewToken(VaultHttp& http, long remainingTtl) {
+        std::cout << "♻️ [" << tenant.id << "] 토큰 갱신 시도 (잔여 TTL=" << remainingTtl << "초)" << std::endl;
         const auto url = config.vaultAddr + "/v1/auth/token/renew-self";
         std::string response;
 
-        const auto httpCode = executePost(url, "{}", currentToken, response);
+        const auto httpCode = http.executePost(control, url, "{}", tenant.namespaceId, *token(), response);
         if (httpCode != 200)
-            throw std::runtime_error("토큰 갱신 실패: " + std::to_string(httpCode));
+            throw VaultRequestError("토큰 갱신 실패: " + std::to_string(httpCode), httpCode);
 
         const auto root = json::parse(response);
         const auto& auth = root.at("auth");
 
+        std::lock_guard<std::mutex> lock(stateMutex);
         const auto oldTtl = leaseDurationSeconds;
         leaseDurationSeconds = auth.at("lease_duration").get<long>();
-        authTimeEpochSeconds = duration_cast<seconds>(system_clock::now().time_since_epoch()).count();
+        isRenewable = auth.value("renewable", isRenewable);
+        ttlReceivedAt = steady_clock::now();
+        scheduleNextAction();
+        metrics.renewals++;
+
+        std::cout << "✅ [" << tenant.id << "] 토큰 갱신 성공: 새 TTL=" << leaseDurationSeconds
+                  << " (이전=" << oldTtl << ")" << std::endl;
+    }
 
-        std::cout << "✅ 토큰 갱신 성공: 새 TTL=" << leaseDurationSeconds << " (이전=" << oldTtl << ")" << std::endl;
+    // stateMutex 를 잡은 상태에서 호출
+    void scheduleNextAction() {
+        if (leaseDurationSeconds <= 0) {
+            // TTL 0: 만료되지 않는 토큰 → 403 재인증 요청만 대기
+            loginRequired = false;
+            nextActionTime = steady_clock::time_point::max();
+            return;
+        }
+
+        // 갱신 TTL 이 로그인 TTL 보다 짧으면 최대 TTL 에 걸린 것이므로 다음 시점에는 재로그인
+        loginRequired = !isRenewable || leaseDurationSeconds < loginLeaseSeconds;
+        const auto renewAfterMs = static_cast<long>(
+            leaseDurationSeconds * 1000 * (1.0 - config.tokenRenewalThresholdPercent / 100.0));
+        nextActionTime = ttlReceivedAt + milliseconds(renewAfterMs);
+    }
+
+    // 실패한 작업을 지터 백오프 후 재시도. 갱신 실패는 토큰이 거부(403)됐거나 재시도 전에
+    // 만료되는 경우에만 재로그인으로 전환하고, 429/5xx/서킷 OPEN 은 renew-self 를 다시 시도합니다.
+    // (장애 복구 직후 모든 클라이언트가 유효한 토큰을 버리고 동시에 로그인하는 것을 방지)
+    void scheduleRetry(const std::exception& e, bool wasLogin, long httpCode = 0) {
+        const auto delay = retryBackoff.next();
+        (wasLogin ? metrics.loginFailures : metrics.renewFailures)++;
+
+        std::lock_guard<std::mutex> lock(stateMutex);
+        const auto now = steady_clock::now();
+        const bool expiresBeforeRetry = leaseDurationSeconds > 0 && ttlReceivedAt + seconds(leaseDurationSeconds) <= now + delay;
+        if (wasLogin || httpCode == 403 || expiresBeforeRetry) loginRequired = true;
+        nextActionTime = now + delay;
+
+        std::cerr << "❌ [" << tenant.id << "] 토큰 " << (wasLogin ? "재인증" : "갱신") << " 오류: " << e.what()
+                  << " → " << delay.count() << "ms 후 " << (loginRequired ? "재인증" : "갱신") << " 재시도" << std::endl;
     }
 
+public:
+    // 403 보고 결과: 새 토큰으로 재시도 / 경로 권한 거부 / 토큰 확인 중이므로 이번 주기는 테넌트 건너뜀
+    enum class ForbiddenVerdict { RetryWithNewToken, PathDenied, SkipTenant };
+
+    TokenManager(const Config& cfg, const TenantConfig& tenantConfig, TenantMetrics& tenantMetrics,
+                 RequestControl& requestControl)
+        : config(cfg), tenant(tenantConfig), metrics(tenantMetrics), control(requestControl),
+          retryBackoff(cfg.backoffBaseMs, cfg.backoffMaxMs) {}
+
+    const std::string& tenantId() const { return tenant.id; }
+
+    void setWakeCallback(std::function<void()> callback) { wakeScheduler = std::move(callback); }
+
+    // 최초 인증. 실패하면 스케줄러가 백오프 후 재시도하도록 예약하고 false 반환
+    bool start(VaultHttp& http) {
+        try {
+            reauthenticate(http);
+            return true;
+        } catch (const std::exception& e) {
+            scheduleRetry(e, true);
+            return false;
+        }
+    }
+
+    // 다음 작업 시각 (403 토큰 확인 요청이 있으면 즉시)
+    steady_clock::time_point dueTime() const {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        return reauthRequested ? steady_clock::time_point::min() : nextActionTime;
+    }
+
+    // 403 토큰 확인, 갱신 또는 재인증 수행 (TokenScheduler 스레드에서 호출). 새 토큰으로 교체되면 true
+    bool runDueAction(VaultHttp& http) {
+        std::shared_ptr<const std::string> suspect;
+        bool doLogin;
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            if (reauthRequested) suspect = currentToken;
+            doLogin = loginRequired || !currentToken;
+            reauthRequested = false;
+        }
+
+        // 403 확인 요청: 토큰이 무효일 때만 재인증, 유효하면 예정된 작업은 다음 시점에 수행
+        if (suspect) {
+            if (!confirmTokenRejected(http, suspect)) return false;
+            doLogin = true;
+        }
+
+        try {
+            if (doLogin) {
+                std::cout << "🔄 [" << tenant.id << "] 백그라운드 재인증 시작 (기존 토큰은 교체 전까지 계속 사용)" << std::endl;
+                reauthenticate(http);
+            } else {
+                renewToken(http, getRemainingTtl());
+            }
+            retryBackoff.reset();
+            return doLogin;
+        } catch (const VaultRequestError& e) {
+            scheduleRetry(e, doLogin, e.httpCode);
+        } catch (const std::exception& e) {
+            scheduleRetry(e, doLogin);
+        }
+        return false;
+    }
+
+    // 아직 인증되지 않았으면 nullptr
+    std::shared_ptr<const std::string> token() const {
+        return std::atomic_load(&currentToken);
+    }
+
+    // 조회에 쓸 수 있는 토큰이 있는지 (미인증, 403 확인 대기 중, 무효 확인 후 재인증 대기 중이면 false)
+    bool hasUsableToken() const {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        const auto current = std::atomic_load(&currentToken);
+        return current && !reauthRequested && current != deadToken;
+    }
+
+    // 403 을 받은 토큰으로 호출 (대기하지 않음). 토큰 확인/재인증은 TokenScheduler 스레드가 수행하므로
+    // 한 테넌트의 재인증 지연이 공유 갱신 루프를 막지 않습니다.
+    ForbiddenVerdict reportForbidden(const std::shared_ptr<const std::string>& rejected) {
+        metrics.forbidden++;
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            if (std::atomic_load(&currentToken) != rejected) return ForbiddenVerdict::RetryWithNewToken;
+            if (verifiedToken == rejected && steady_clock::now() - verifiedAt < forbiddenRecheckInterval)
+                return ForbiddenVerdict::PathDenied;
+            if (reauthRequested || deadToken == rejected) return ForbiddenVerdict::SkipTenant;
+            reauthRequested = true;
+        }
+        if (wakeScheduler) wakeScheduler();
+        return ForbiddenVerdict::SkipTenant;
+    }
+
+    long getRemainingTtl() const {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        return leaseDurationSeconds - duration_cast<seconds>(steady_clock::now() - ttlReceivedAt).count();
+    }
+};
+
+// =========================================================
+// Token Scheduler
+// =========================================================
+// 모든 테넌트의 토큰 갱신/재인증을 하나의 백그라운드 스레드와 cURL 핸들로 처리합니다.
+// 가장 이른 작업 시각까지 대기하고, 403 재인증 요청이 들어오면 즉시 깨어납니다.
+// 재인증으로 토큰이 교체되면 Secret 갱신 루프를 깨워 건너뛴 경로를 바로 다시 조회하게 합니다.
+class TokenScheduler {
+private:
+    VaultHttp http;
+    std::vector<TokenManager*> managers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool wakeRequested = false;
+    bool stopRequested = false;
+    std::condition_variable tokenSwapSignal;  // mutex 로 보호되는 tokenSwapped 와 함께 사용
+    bool tokenSwapped = false;
+    std::thread worker;
+
+    void run() {
+        while (true) {
+            // 테넌트 락은 스케줄러 락 밖에서 잡음 (reportForbidden → notify 순서와의 교착 방지)
+            auto earliest = steady_clock::time_point::max();
+            for (const auto* manager : managers)
+                earliest = std::min(earliest, manager->dueTime());
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                const auto wakeCondition = [this] { return stopRequested || wakeRequested; };
+                if (earliest == steady_clock::time_point::max())
+                    wake.wait(lock, wakeCondition);
+                else
+                    wake.wait_until(lock, earliest, wakeCondition);
+                if (stopRequested) return;
+                wakeRequested = false;
+            }
+
+            const auto now = steady_clock::now();
+            bool swapped = false;
+            for (auto* manager : managers)
+                if (manager->dueTime() <= now && manager->runDueAction(http)) swapped = true;
+
+            if (swapped) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    tokenSwapped = true;
+                }
+                tokenSwapSignal.notify_all();
+            }
+        }
+    }
+
+public:
+    TokenScheduler(const Config& config, RequestTracer& tracer, SharedConnectionPool& connectionPool)
+        : http(config, tracer, connectionPool) {}
+
+    ~TokenScheduler() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopRequested = true;
+        }
+        wake.notify_all();
+        if (worker.joinable()) worker.join();
+    }
+
+    // start() 전에 모든 테넌트를 등록
+    void add(TokenManager& manager) {
+        manager.setWakeCallback([this] { notify(); });
+        managers.push_back(&manager);
+    }
+
+    void start() {
+        worker = std::thread(&TokenScheduler::run, this);
+    }
+
+    void notify() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            wakeRequested = true;
+        }
+        wake.notify_all();
+    }
+
+    // Secret 갱신 루프의 주기 대기: deadline 전에 토큰이 교체되면 true 를 반환하고 즉시 깨어남
+    bool waitForTokenSwap(steady_clock::time_point deadline) {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!tokenSwapSignal.wait_until(lock, deadline, [this] { return tokenSwapped; })) return false;
+        tokenSwapped = false;
+        return true;
+    }
+};
+
+// =========================================================
+// Secret Renderer
+// =========================================================
+// secretsCache 를 템플릿/.env/JSON 파일로 렌더링합니다.
+// - 테넌트 캐시가 바뀐 주기에만 렌더링하고, 출력 해시가 마지막으로 쓴 내용과 같으면 쓰지 않음
+// - env/json 은 필요한 경로가 모두 한 번 이상 조회된 뒤에만 렌더링 (일부 경로만으로 기존 파일을 덮어쓰지 않음)
+// - 값 누락/쓰기 실패 시 다음 주기에 다시 시도
+// - 같은 디렉토리의 임시 파일에 쓰고 fsync 후 rename 하여 소비자는 항상 완전한 파일만 읽음
+// - 내용이 바뀐 경우에만 지정 PID 에 시그널을 보내거나 훅 실행 (훅 종료는 다음 주기에 비차단으로 회수)
+class SecretRenderer {
+public:
+    using SecretsCache = std::map<std::string, std::map<std::string, std::string>>;
+
+private:
+    const RenderTargetConfig& target;
+    const std::vector<std::string>& requiredPaths;  // target.paths, 미지정 시 테넌트의 kv_secrets_paths
+    std::string templateText;
+    std::string output;  // 렌더링 버퍼 (주기마다 재사용)
+    size_t lastWrittenHash = 0;
+    bool hasWrittenHash = false;
+    long renderedGeneration = -1;
+    pid_t hookChild = -1;      // 실행 중인 훅 프로세스 (-1: 없음)
+    bool hookPending = false;  // 훅 실행 중 내용이 다시 바뀌어 종료 후 한 번 더 실행해야 함
+
+    static std::string readFile(const std::string& path, bool& found) {
+        std::ifstream file(path, std::ios::binary);
+        found = file.is_open();
+        if (!found) return {};
+        std::ostringstream ss;
+        ss << file.rdbuf();
+        return ss.str();
+    }
+
+    static std::string trim(const std::string& text) {
+        const auto begin = text.find_first_not_of(" \t\r\n");
+        if (begin == std::string::npos) return {};
+        const auto end = text.find_last_not_of(" \t\r\n");
+        return text.substr(begin, end - begin + 1);
+    }
+
+    static const std::string* lookup(const SecretsCache& cache, const std::string& path, const std::string& key) {
+        const auto pathIt = cache.find(path);
+        if (pathIt == cache.end()) return nullptr;
+        const auto keyIt = pathIt->second.find(key);
+        return keyIt == pathIt->second.end() ? nullptr : &keyIt->second;
+    }
+
+    // {{ path:key }} 또는 {{ path:key | json }} (JSON 문자열 리터럴로 이스케이프)
+    bool renderTemplate(const SecretsCache& cache) {
+        size_t pos = 0;
+        while (true) {
+            const auto open = templateText.find("{{", pos);
+            if (open == std::string::npos) break;
+            const auto close = templateText.find("}}", open + 2);
+            if (close == std::string::npos) break;
+            output.append(templateText, pos, open - pos);
+
+            auto expression = templateText.substr(open + 2, close - open - 2);
+            bool asJson = false;
+            const auto pipe = expression.find('|');
+            if (pipe != std::string::npos) {
+                asJson = trim(expression.substr(pipe + 1)) == "json";
+                expression.erase(pipe);
+            }
+            const auto colon = expression.find(':');
+            const auto* value = colon == std::string::npos
+                                    ? nullptr
+                                    : lookup(cache, trim(expression.substr(0, colon)), trim(expression.substr(colon + 1)));
+            if (!value) {
+                std::cerr << "⚠️ [render:" << target.id << "] 값을 찾을 수 없어 렌더링 생략: {{" << expression << "}}" << std::endl;
+                return false;
+            }
+            output += asJson ? json(*value).dump() : *value;
+            pos = close + 2;
+        }
+        output.append(templateText, pos, std::string::npos);
+        return true;
+    }
+
+    // KEY=value (키는 대문자, 영숫자 외 문자는 '_', 특수 문자가 있는 값은 큰따옴표로 감쌈)
+    static void appendEnvLine(std::string& out, const std::string& key, const std::string& value) {
+        for (const char c : key)
+            out += std::isalnum(static_cast<unsigned char>(c)) ? static_cast<char>(std::toupper(static_cast<unsigned char>(c))) : '_';
+        out += '=';
+
+        const bool plain = !value.empty() && std::all_of(value.begin(), value.end(), [](char c) {
+            return std::isalnum(static_cast<unsigned char>(c)) || std::strchr("_-./:@+,", c) != nullptr;
+        });
+        if (plain) {
+            out += value;
+        } else {
+            out += '"';
+            for (const char c : value) {
+                if (c == '\n') { out += "\\n"; continue; }
+                if (c == '"' || c == '\\' || c == '$' || c == '`') out += '\\';
+                out += c;
+            }
+            out += '"';
+        }
+        out += '\n';
+    }
+
+    // 필요한 경로가 모두 캐시에 있는지 (첫 조회 전이거나 조회 실패 중인 경로가 있으면 false)
+    bool requiredPathsCached(const SecretsCache& cache) const {
+        for (const auto& path : requiredPaths) {
+            if (cache.find(path) == cache.end()) {
+                std::cerr << "⚠️ [render:" << target.id << "] 아직 조회되지 않은 경로라 렌더링 보류: " << path << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool renderEnv(const SecretsCache& cache) {
+        if (!requiredPathsCached(cache)) return false;
+        for (const auto& path : requiredPaths)
+            for (const auto& [key, value] : cache.at(path)) appendEnvLine(output, key, value);
+        return true;
+    }
+
+    // 경로가 하나면 평면 객체, 여러 개면 {"경로": {...}} 형태
+    bool renderJson(const SecretsCache& cache) {
+        if (!requiredPathsCached(cache)) return false;
+        json root = json::object();
+        for (const auto& path : requiredPaths) {
+            auto& node = requiredPaths.size() == 1 ? root : root[path];
+            for (const auto& [key, value] : cache.at(path)) node[key] = value;
+        }
+        output = root.dump(2);
+        output += '\n';
+        return true;
+    }
+
+    // 임시 파일 → fsync → rename (같은 파일 시스템 안에서 원자적 교체)
+    void writeAtomically() const {
+        const auto tmpPath = target.destination + ".tmp." + std::to_string(::getpid());
+        const int fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, target.fileMode);
+        if (fd < 0) throw std::runtime_error("임시 파일 생성 실패: " + tmpPath + " (" + std::strerror(errno) + ")");
+
+        size_t written = 0;
+        while (written < output.size()) {
+            const auto n = ::write(fd, output.data() + written, output.size() - written);
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0) {
+                const std::string reason = std::strerror(errno);
+                ::close(fd);
+                ::unlink(tmpPath.c_str());
+                throw std::runtime_error("파일 쓰기 실패: " + tmpPath + " (" + reason + ")");
+            }
+            written += static_cast<size_t>(n);
+        }
+        // umask 와 무관하게 설정한 권한 적용. 권한/디스크 반영(fsync)/close 중 하나라도 실패하면 교체하지 않음
+        std::string failure;
+        if (::fchmod(fd, target.fileMode) != 0)
+            failure = std::string("권한 설정 실패 (") + std::strerror(errno) + ")";
+        else if (::fsync(fd) != 0)
+            failure = std::string("fsync 실패 (") + std::strerror(errno) + ")";
+        if (::close(fd) != 0 && failure.empty())
+            failure = std::string("close 실패 (") + std::strerror(errno) + ")";
+        if (!failure.empty()) {
+            ::unlink(tmpPath.c_str());
+            throw std::runtime_error("임시 파일 " + failure + ": " + tmpPath);
+        }
+
+        if (::rename(tmpPath.c_str(), target.destination.c_str()) != 0) {
+            const std::string reason = std::strerror(errno);
+            ::unlink(tmpPath.c_str());
+            throw std::runtime_error("파일 교체 실패: " + target.destination + " (" + reason + ")");
+        }
+    }
+
+    void notifyConsumers() {
+        if (!target.signalPidFile.empty()) {
+            bool found = false;
+            const auto pidText = trim(readFile(target.signalPidFile, found));
+            const auto pid = found ? std::atol(pidText.c_str()) : 0;
+            if (pid <= 0) {
+                std::cerr << "⚠️ [render:" << target.id << "] PID 파일을 읽을 수 없습니다: " << target.signalPidFile << std::endl;
+            } else if (::kill(static_cast<pid_t>(pid), target.signal) != 0) {
+                std::cerr << "⚠️ [render:" << target.id << "] 시그널 전송 실패: PID " << pid << " (" << std::strerror(errno) << ")" << std::endl;
+            } else {
+                std::cout << "📣 [render:" << target.id << "] 시그널 " << target.signal << " 전송: PID " << pid << std::endl;
+            }
+        }
+
+        if (!target.command.empty()) {
+            // 이전 훅이 아직 실행 중이면 겹쳐 실행하지 않고, 종료 회수 후 한 번 더 실행
+            if (hookChild > 0) {
+                hookPending = true;
+                return;
+            }
+            launchHook();
+        }
+    }
+
+    // 훅은 렌더링된 파일 경로를 첫 번째 인자로 받음. 종료를 기다리지 않음 (reapHook 에서 회수)
+    void launchHook() {
+        hookPending = false;
+        const pid_t child = ::fork();
+        if (child == 0) {
+            ::execl(target.command.c_str(), target.command.c_str(), target.destination.c_str(), static_cast<char*>(nullptr));
+            ::_exit(127);
+        }
+        if (child < 0) {
+            std::cerr << "⚠️ [render:" << target.id << "] 훅 실행 실패: " << target.command << " (" << std::strerror(errno) << ")" << std::endl;
+            return;
+        }
+        hookChild = child;
+    }
+
+    // 갱신 주기마다 호출: 종료된 훅을 비차단(WNOHANG)으로 회수하고 결과를 기록
+    void reapHook() {
+        if (hookChild <= 0) return;
+        int status = 0;
+        const pid_t result = ::waitpid(hookChild, &status, WNOHANG);
+        if (result == 0) return;  // 아직 실행 중
+        if (result < 0) {
+            std::cerr << "⚠️ [render:" << target.id << "] 훅 종료 확인 실패: " << target.command << " (" << std::strerror(errno) << ")" << std::endl;
+        } else if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            std::cerr << "⚠️ [render:" << target.id << "] 훅 비정상 종료: " << target.command
+                      << " (status=" << (WIFEXITED(status) ? WEXITSTATUS(status) : -1) << ")" << std::endl;
+        } else {
+            std::cout << "🪝 [render:" << target.id << "] 훅 실행 완료: " << target.command << std::endl;
+        }
+        hookChild = -1;
+        if (hookPending) launchHook();
+    }
+
+public:
+    SecretRenderer(const RenderTargetConfig& targetConfig, const std::vector<std::string>& tenantPaths)
+        : target(targetConfig), requiredPaths(targetConfig.paths.empty() ? tenantPaths : targetConfig.paths) {
+        bool found = false;
+        if (target.format == "template") {
+            templateText = readFile(target.templateFile, found);
+            if (!found) throw std::runtime_error("❌ Error: 템플릿 파일을 열 수 없습니다: " + target.templateFile);
+        }
+
+        // 재시작 시 기존 파일과 내용이 같으면 다시 쓰거나 알리지 않도록 기존 내용 해시로 시작
+        const auto existing = readFile(target.destination, found);
+        if (found) {
+            lastWrittenHash = std::hash<std::string>{}(existing);
+            hasWrittenHash = true;
+        }
+    }
+
+    // generation: 테넌트 캐시가 바뀔 때마다 증가하는 값. 마지막으로 반영에 성공한 값과 같으면 렌더링 자체를 생략
+    void render(const SecretsCache& cache, long generation) {
+        reapHook();
+        if (generation == renderedGeneration) return;
+
+        output.clear();
+        bool rendered = false;
+        if (target.format == "env")
+            rendered = renderEnv(cache);
+        else if (target.format == "json")
+            rendered = renderJson(cache);
+        else
+            rendered = renderTemplate(cache);
+        if (!rendered) return;
+
+        const auto hash = std::hash<std::string>{}(output);
+        if (hasWrittenHash && hash == lastWrittenHash) {
+            renderedGeneration = generation;
+            return;
+        }
+
+        try {
+            writeAtomically();
+        } catch (const std::exception& e) {
+            std::cerr << "❌ [render:" << target.id << "] " << e.what() << std::endl;
+            return;
+        }
+        renderedGeneration = generation;
+        lastWrittenHash = hash;
+        hasWrittenHash = true;
+        std::cout << "📝 [render:" << target.id << "] 파일 갱신: " << target.destination << " (" << output.size() << " bytes)" << std::endl;
+        notifyConsumers();
+    }
+};
+
+// =========================================================
+// Vault Client
+// =========================================================
+// 여러 테넌트(네임스페이스 + AppRole + 경로 목록)를 하나의 프로세스에서 처리합니다.
+// 모든 테넌트가 연결 풀(SharedConnectionPool), 요청 제어, 토큰 스케줄러, Secret 갱신 루프를 공유합니다.
+class VaultClient {
+private:
+    // 경로별 상태: 미리 만든 요청, 캐시된 버전, 재시도 일정
+    // (429/503 등 실패 시 백오프가 끝날 때까지 해당 경로 조회를 건너뜀)
+    // awaitingToken: 쓸 수 있는 토큰이 없어 건너뜀 → 토큰 교체 직후 바로 다시 조회
+    struct PathState {
+        PreparedRequest request;
+        long cachedVersion = -1;
+        steady_clock::time_point nextAttempt;
+        DecorrelatedJitterBackoff backoff;
+        bool awaitingToken = false;
+    };
+
+    struct Tenant {
+        const TenantConfig& config;
+        TenantMetrics metrics;
+        RequestControl control;
+        TokenManager tokenManager;
+        std::vector<PathState> pathStates;
+        SecretRenderer::SecretsCache secretsCache;
+        long cacheGeneration = 0;  // secretsCache 가 바뀔 때마다 증가 (렌더링 생략 판단용)
+        std::vector<std::unique_ptr<SecretRenderer>> renderers;
+
+        Tenant(const Config& clientConfig, const TenantConfig& tenantConfig, RateLimiter& rateLimiter)
+            : config(tenantConfig), control(clientConfig, rateLimiter, tenantConfig.id),
+              tokenManager(clientConfig, tenantConfig, metrics, control) {
+            pathStates.reserve(tenantConfig.kvSecretsPaths.size());
+            for (const auto& path : tenantConfig.kvSecretsPaths)
+                pathStates.push_back(PathState{PreparedRequest(clientConfig, tenantConfig, path), -1, steady_clock::now(),
+                                               DecorrelatedJitterBackoff(clientConfig.backoffBaseMs, clientConfig.backoffMaxMs),
+                                               false});
+        }
+    };
+
+    Config config;
+    SharedConnectionPool connectionPool;
+    RateLimiter rateLimiter;
+    RequestTracer tracer;
+    VaultHttp http;
+    ResponseBufferPool responseBuffers{2};
+    std::vector<std::unique_ptr<Tenant>> tenants;
+    TokenScheduler tokenScheduler;  // tenants 보다 먼저 소멸(스레드 종료)되도록 뒤에 선언
+
+    // 정상 상태 힙 할당 테스트(tests/SteadyStateAllocTest.cpp)가 갱신 주기를 직접 구동
+    friend struct SteadyStateAllocTest;
+
     // ---------------------------------------------------------
     // KV Secret 조회
     // ---------------------------------------------------------
-    void readKvSecret(const std::string& secretPath) {
-        const auto url = config.vaultAddr + "/v1/" + config.kvMountPath + "/data/" + secretPath;
-        std::string response;
-        const auto httpCode = executeGet(url, currentToken, response);
+    // 정상 상태(데이터 변경 없음)에서는 URL/헤더/응답 버퍼를 재사용하고, 버전이 같으면
+    // JSON 파싱과 캐시 갱신을 생략하므로 힙 할당이 발생하지 않습니다.
+    long readKvSecret(Tenant& tenant, PathState& state) {
+        const auto& secretPath = state.request.path();
+        auto token = tenant.tokenManager.token();
+        auto buffer = responseBuffers.acquire();
+        auto& response = buffer.get();
+        tenant.metrics.kvReads++;
+        auto httpCode = http.executeGet(tenant.control, state.request.url(), state.request.headersFor(token), response);
+
+        // 403: 이미 교체된 토큰이면 새 토큰으로 한 번 재시도, 아니면 토큰 확인을 요청하고 대기하지 않음
+        if (httpCode == 403) {
+            switch (tenant.tokenManager.reportForbidden(token)) {
+            case TokenManager::ForbiddenVerdict::RetryWithNewToken:
+                token = tenant.tokenManager.token();
+                response.clear();
+                httpCode = http.executeGet(tenant.control, state.request.url(), state.request.headersFor(token), response);
+                break;
+            case TokenManager::ForbiddenVerdict::PathDenied:
+                std::cerr << "⚠️ [" << tenant.config.id << "] Secret 조회 403: " << secretPath << " → 경로 권한 거부" << std::endl;
+                break;
+            case TokenManager::ForbiddenVerdict::SkipTenant:
+                state.awaitingToken = true;
+                std::cerr << "⚠️ [" << tenant.config.id << "] Secret 조회 403: " << secretPath
+                          << " → 토큰 확인 중, 토큰 교체 후 다시 조회" << std::endl;
+                break;
+            }
+        }
 
         if (httpCode != 200) {
-            std::cerr << "❌ Secret 조회 실패: " << secretPath << " (HTTP " << httpCode << ")" << std::endl;
-            return;
+            tenant.metrics.kvFailures++;
+            std::cerr << "❌ [" << tenant.config.id << "] Secret 조회 실패: " << secretPath << " (HTTP " << httpCode << ")" << std::endl;
+            return httpCode;
+        }
+
+        long version = 0;
+        if (findKvVersion(response, version) && version == state.cachedVersion) {
+            tenant.metrics.kvUnchanged++;
+            std::cout << "✅ [" << tenant.config.id << "] Secret 변경 없음: " << secretPath << " (Version=" << version << ")" << std::endl;
+            return httpCode;
         }
 
+        const auto parseStartUs = tracer.enabled() ? tracer.nowUs() : 0;
         const auto root = json::parse(response);
+        if (tracer.enabled())
+            tracer.recordSpan("parse " + secretPath, "parse", parseStartUs, tracer.nowUs() - parseStartUs,
+                              "\"bytes\":" + std::to_string(response.size()));
         const auto& dataNode = root.at("data").at("data");
         const auto& metadata = root.at("data").at("metadata");
 
-        std::map<std::string, std::string> secretData;
+        // 기존 노드/문자열 용량을 재사용하여 제자리 갱신, 사라진 키만 제거
+        auto& secretData = tenant.secretsCache[secretPath];
+        for (auto it = secretData.begin(); it != secretData.end();) {
+            if (dataNode.contains(it->first))
+                ++it;
+            else
+                it = secretData.erase(it);
+        }
         for (const auto& [key, val] : dataNode.items()) {
             if (val.is_string())
-                secretData[key] = val.get<std::string>();
+                secretData[key].assign(val.get_ref<const std::string&>());
             else
                 secretData[key] = val.dump();
         }
 
-        secretsCache[secretPath] = std::move(secretData);
-
         std::string versionStr;
         try {
             const auto& versionNode = metadata.at("version");
             versionStr = versionNode.is_number() ? std::to_string(versionNode.get<int>()) : versionNode.get<std::string>();
+            state.cachedVersion = versionNode.is_number() ? versionNode.get<long>() : -1;
         } catch (...) {
             versionStr = "N/A";
+            state.cachedVersion = -1;
+        }
+
+        tenant.cacheGeneration++;
+        tenant.metrics.kvUpdated++;
+        std::cout << "✅ [" << tenant.config.id << "] Secret 갱신 완료: " << secretPath << " (Version=" << versionStr << ")" << std::endl;
+        return httpCode;
+    }
+
+    // 모든 테넌트에 대해 백오프 중이 아닌 경로만 조회하고, 재시도 가능한 실패는 경로별 백오프 적용
+    // awaitingTokenOnly: 토큰 교체 직후 호출. 토큰이 없어 건너뛴 경로만 다시 조회
+    void refreshSecrets(bool awaitingTokenOnly = false) {
+        const auto cycleStartUs = tracer.enabled() ? tracer.nowUs() : 0;
+        long attempted = 0;
+        long failed = 0;
+
+        for (auto& tenant : tenants) {
+            const auto tenantStart = steady_clock::now();
+            long tenantAttempted = 0;
+            for (auto& state : tenant->pathStates) {
+                if (awaitingTokenOnly && !state.awaitingToken) continue;
+                // 인증 전이거나 403 토큰 확인/재인증 대기 중이면 건너뜀 (토큰 스케줄러가 처리 후 깨움)
+                if (!tenant->tokenManager.hasUsableToken()) {
+                    state.awaitingToken = true;
+                    continue;
+                }
+                if (steady_clock::now() < state.nextAttempt) continue;
+                state.awaitingToken = false;
+                ++attempted;
+                ++tenantAttempted;
+
+                long httpCode = 0;
+                try {
+                    httpCode = readKvSecret(*tenant, state);
+                } catch (const std::exception& e) {
+                    std::cerr << "❌ [" << tenant->config.id << "] Secret 응답 처리 오류: " << state.request.path()
+                              << " → " << e.what() << std::endl;
+                }
+
+                if (httpCode != 200) ++failed;
+                if (isRetryableStatus(httpCode)) {
+                    const auto delay = state.backoff.next();
+                    state.nextAttempt = steady_clock::now() + delay;
+                    std::cerr << "⏳ [" << tenant->config.id << "] " << state.request.path() << " 조회 백오프: "
+                              << delay.count() << "ms" << std::endl;
+                } else {
+                    state.backoff.reset();
+                }
+            }
+            if (tenantAttempted > 0)
+                tenant->metrics.lastCycleMs = duration_cast<milliseconds>(steady_clock::now() - tenantStart).count();
         }
 
-        std::cout << "✅ Secret 갱신 완료: " << secretPath << " (Version=" << versionStr << ")" << std::endl;
+        if (tracer.enabled())
+            tracer.recordSpan("refresh_cycle", "cycle", cycleStartUs, tracer.nowUs() - cycleStartUs,
+                              "\"paths\":" + std::to_string(attempted) + ",\"failed\":" + std::to_string(failed));
     }
 
-    long getRemainingTtl() const {
-        const auto now = duration_cast<seconds>(system_clock::now().time_since_epoch()).count();
-        return leaseDurationSeconds - (now - authTimeEpochSeconds);
+    // 캐시가 바뀐 테넌트의 렌더링 대상만 다시 렌더링 (내용이 같으면 파일은 건드리지 않음)
+    void renderSecrets() {
+        for (auto& tenant : tenants)
+            for (auto& renderer : tenant->renderers)
+                renderer->render(tenant->secretsCache, tenant->cacheGeneration);
     }
 
     void printSecretsCache() const {
         std::cout << "\n📋 [Secrets Cache]" << std::endl;
-        for (const auto& [path, kvPairs] : secretsCache) {
-            std::cout << "  [" << path << "]" << std::endl;
-            for (const auto& [k, v] : kvPairs)
-                std::cout << "    " << k << ": " << v << std::endl;
+        for (const auto& tenant : tenants) {
+            for (const auto& [path, kvPairs] : tenant->secretsCache) {
+                std::cout << "  [" << tenant->config.id << ":" << path << "]" << std::endl;
+                for (const auto& [k, v] : kvPairs)
+                    std::cout << "    " << k << ": " << v << std::endl;
+            }
         }
         std::cout << "-------------------------------\n" << std::endl;
     }
 
-public:
-    VaultClient() : config("config.properties") {
-        curl = curl_easy_init();
-        if (!curl) throw std::runtime_error("❌ cURL 초기화 실패.");
+    void printTenantMetrics() const {
+        std::cout << "📊 [Tenant Metrics]" << std::endl;
+        std::cout << "  " << std::left << std::setw(16) << "tenant" << std::right << std::setw(8) << "ttl(s)"
+                  << std::setw(8) << "login" << std::setw(8) << "renew" << std::setw(8) << "403"
+                  << std::setw(9) << "kv_read" << std::setw(9) << "updated" << std::setw(10) << "unchanged"
+                  << std::setw(8) << "failed" << std::setw(10) << "cycle_ms" << std::endl;
+        for (const auto& tenant : tenants) {
+            const auto& m = tenant->metrics;
+            std::cout << "  " << std::left << std::setw(16) << tenant->config.id << std::right
+                      << std::setw(8) << tenant->tokenManager.getRemainingTtl()
+                      << std::setw(8) << m.logins << std::setw(8) << m.renewals << std::setw(8) << m.forbidden
+                      << std::setw(9) << m.kvReads << std::setw(9) << m.kvUpdated << std::setw(10) << m.kvUnchanged
+                      << std::setw(8) << m.kvFailures << std::setw(10) << m.lastCycleMs << std::endl;
+        }
+        std::cout << std::endl;
     }
 
-    ~VaultClient() {
-        if (curl) curl_easy_cleanup(curl);
-        curl_global_cleanup();
+public:
+    VaultClient()
+        : config("config.properties"), rateLimiter(config.rateLimitRequestsPerSecond, config.rateLimitBurst),
+          tracer(config), http(config, tracer, connectionPool), tokenScheduler(config, tracer, connectionPool) {
+        tenants.reserve(config.tenants.size());
+        for (const auto& tenantConfig : config.tenants) {
+            tenants.push_back(std::make_unique<Tenant>(config, tenantConfig, rateLimiter));
+            tokenScheduler.add(tenants.back()->tokenManager);
+        }
+
+        for (const auto& target : config.renderTargets) {
+            const auto it = std::find_if(tenants.begin(), tenants.end(),
+                                         [&target](const auto& tenant) { return tenant->config.id == target.tenantId; });
+            if (it == tenants.end())
+                throw std::runtime_error("❌ Error: 렌더링 대상의 테넌트를 찾을 수 없습니다: " + target.id + " → " + target.tenantId);
+            for (const auto& path : target.paths) {
+                const auto& tenantPaths = (*it)->config.kvSecretsPaths;
+                if (std::find(tenantPaths.begin(), tenantPaths.end(), path) == tenantPaths.end())
+                    throw std::runtime_error("❌ Error: 렌더링 경로가 테넌트의 kv_secrets_paths 에 없습니다: " + target.id + " → " + path);
+            }
+            (*it)->renderers.push_back(std::make_unique<SecretRenderer>(target, (*it)->config.kvSecretsPaths));
+        }
     }
 
     void run() {
-        authenticate();
+        // 최초 인증: 실패한 테넌트는 토큰 스케줄러가 백오프 후 재시도. 모두 실패하면 종료
+        size_t authenticated = 0;
+        for (auto& tenant : tenants)
+            if (tenant->tokenManager.start(http)) ++authenticated;
+        if (authenticated == 0)
+            throw std::runtime_error("모든 테넌트의 AppRole 인증 실패");
+        tokenScheduler.start();
 
-        std::cout << "\n🔎 초기 KV Secrets 조회..." << std::endl;
-        for (const auto& path : config.kvSecretsPaths)
-            readKvSecret(path);
+        std::cout << "\n🔎 초기 KV Secrets 조회 (테넌트 " << tenants.size() << "개)..." << std::endl;
+        refreshSecrets();
+        renderSecrets();
         printSecretsCache();
 
         const auto interval = config.kvRenewalIntervalSeconds;
-        const auto renewalThreshold = static_cast<long>(
-            config.tokenRenewalThresholdPercent / 100.0 * leaseDurationSeconds);
 
-        std::cout << "\n♻️ 주기적 토큰/Secret 갱신 시작 (Interval=" << interval << "s)" << std::endl;
+        std::cout << "\n♻️ 주기적 Secret 갱신 시작 (Interval=" << interval << "s, 토큰은 백그라운드 관리)" << std::endl;
 
+        auto nextCycle = steady_clock::now() + seconds(interval);
         while (true) {
-            std::this_thread::sleep_for(seconds(interval));
-
-            const auto remainingTtl = getRemainingTtl();
-            std::cout << "⏱️ 현재 토큰 TTL: " << remainingTtl << "초" << std::endl;
-
-            if (remainingTtl <= renewalThreshold && remainingTtl > 0) {
-                try {
-                    renewToken(remainingTtl);
-                } catch (const std::exception& e) {
-                    std::cerr << "❌ 토큰 갱신 오류: " << e.what() << std::endl;
-                }
+            // 주기 대기 중 토큰이 교체되면 건너뛴 경로만 즉시 다시 조회 (다음 주기까지 기다리지 않음)
+            if (tokenScheduler.waitForTokenSwap(nextCycle)) {
+                refreshSecrets(true);
+                renderSecrets();
+                continue;
             }
 
-            for (const auto& path : config.kvSecretsPaths)
-                readKvSecret(path);
+            refreshSecrets();
+            renderSecrets();
             printSecretsCache();
+            printTenantMetrics();
+            nextCycle = steady_clock::now() + seconds(interval);
         }
     }
 };
@@ -315,12 +1840,15 @@ public:
 // =========================================================
 int main() {
     curl_global_init(CURL_GLOBAL_DEFAULT);
+    int exitCode = EXIT_SUCCESS;
     try {
+        // 모든 cURL 핸들(easy/share)은 client 소멸 시 정리되므로 global cleanup 은 그 이후에 수행
         VaultClient client;
         client.run();
     } catch (const std::exception& e) {
         std::cerr << "❌ VaultClient 실행 오류: " << e.what() << std::endl;
-        return EXIT_FAILURE;
+        exitCode = EXIT_FAILURE;
     }
-    return EXIT_SUCCESS;
+    curl_global_cleanup();
+    return exitCode;
 }
\ No newline at end of file
@@ -0,0 +1,678 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <map>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <iomanip>
+#include <stdexcept>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <random>
+#include <cmath>
+
+// =========================================================
+// Vault 부하 시뮬레이터
+// =========================================================
+// VaultClient 의 폴링/토큰 관리 동작(주기 조회, renew-self, 재로그인, 403 토큰 확인,
+// 속도 제한, Decorrelated Jitter 백오프, 서킷 브레이커)을 가볍게 모델링한
+// 가상 클라이언트 수천 개를 스레드 풀에서 가상 시간으로 실행하고,
+// 로컬 Mock Vault 가 받는 요청량을 집계합니다.
+//
+// 사용법: ./vault_load_simulator [--config=config.properties] [--clients=1000] [--key=value ...]
+
+// =========================================================
+// Simulation Settings
+// =========================================================
+struct SimSettings {
+    // 클라이언트 설정 (config.properties 와 동일한 의미)
+    long clients = 1000;
+    long paths = 1;
+    double intervalSeconds = 10;
+    double renewalThresholdPercent = 20;
+    double rateLimitRequestsPerSecond = 20;
+    double rateLimitBurst = 40;
+    double backoffBaseMs = 500;
+    double backoffMaxMs = 60000;
+    long breakerFailureThreshold = 5;
+    double breakerOpenSeconds = 30;
+
+    // Mock Vault / 시나리오 설정
+    double durationSeconds = 600;
+    double startupSpreadSeconds = 0;      // 클라이언트 기동 시점 분산 (0: 동시 기동)
+    double tokenTtlSeconds = 3600;
+    double tokenMaxTtlSeconds = 86400;
+    double requestLatencyMs = 5;
+    double vaultCapacityQps = 0;          // 0: 무제한, 초과 시 429
+    double restartAtSeconds = -1;         // Vault 재시작 시점 (-1: 없음)
+    double restartDowntimeSeconds = 30;   // 재시작 중 503 응답 시간
+    bool restartRevokesTokens = true;     // 재시작 후 기존 토큰 무효화 (403)
+    double secretUpdateEverySeconds = 60; // 모든 경로의 Secret 버전 갱신 주기 (0: 없음)
+    long threads = std::max(1u, std::thread::hardware_concurrency());
+    double reportEverySeconds = 10;
+    std::string csvFile;
+    unsigned long seed = 42;
+};
+
+static std::map<std::string, std::string> loadProperties(const std::string& filename) {
+    std::map<std::string, std::string> properties;
+    std::ifstream file(filename);
+    if (!file.is_open()) return properties;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        line.erase(std::remove_if(line.begin(), line.end(), ::isspace), line.end());
+        if (line.empty() || line[0] == '#') continue;
+
+        auto eqPos = line.find('=');
+        if (eqPos != std::string::npos)
+            properties[line.substr(0, eqPos)] = line.substr(eqPos + 1);
+    }
+    return properties;
+}
+
+static SimSettings parseSettings(int argc, char* argv[]) {
+    std::map<std::string, std::string> args;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--", 0) != 0)
+            throw std::runtime_error("알 수 없는 인자: " + arg);
+        const auto eqPos = arg.find('=');
+        if (eqPos == std::string::npos)
+            args[arg.substr(2)] = "1";
+        else
+            args[arg.substr(2, eqPos - 2)] = arg.substr(eqPos + 1);
+    }
+
+    SimSettings s;
+    const auto configFile = args.count("config") ? args["config"] : "config.properties";
+    auto props = loadProperties(configFile);
+
+    // config.properties 값을 기본으로 사용하고, 명령행 인자로 덮어씀
+    const auto number = [&](const std::string& arg, const std::string& prop, double current) {
+        try {
+            if (args.count(arg)) return std::stod(args[arg]);
+            if (!prop.empty() && props.count(prop) && !props[prop].empty()) return std::stod(props[prop]);
+        } catch (...) {
+            throw std::runtime_error("숫자 값을 파싱할 수 없습니다: " + arg);
+        }
+        return current;
+    };
+
+    if (props.count("kv_secrets_paths")) {
+        std::stringstream ss(props["kv_secrets_paths"]);
+        long count = 0;
+        for (std::string path; std::getline(ss, path, ',');)
+            if (!path.empty()) ++count;
+        if (count > 0) s.paths = count;
+    }
+
+    s.clients = static_cast<long>(number("clients", "", s.clients));
+    s.paths = static_cast<long>(number("paths", "", s.paths));
+    s.intervalSeconds = number("interval", "kv_renewal_interval_seconds", s.intervalSeconds);
+    s.renewalThresholdPercent = number("threshold-percent", "token_renewal_threshold_percent", s.renewalThresholdPercent);
+    s.rateLimitRequestsPerSecond = number("rate-limit", "rate_limit_requests_per_second", s.rateLimitRequestsPerSecond);
+    s.rateLimitBurst = number("rate-limit-burst", "rate_limit_burst", s.rateLimitBurst);
+    s.backoffBaseMs = number("backoff-base-ms", "backoff_base_ms", s.backoffBaseMs);
+    s.backoffMaxMs = number("backoff-max-ms", "backoff_max_ms", s.backoffMaxMs);
+    s.breakerFailureThreshold = static_cast<long>(number("breaker-threshold", "circuit_breaker_failure_threshold", s.breakerFailureThreshold));
+    s.breakerOpenSeconds = number("breaker-open-seconds", "circuit_breaker_open_seconds", s.breakerOpenSeconds);
+
+    s.durationSeconds = number("duration", "", s.durationSeconds);
+    s.startupSpreadSeconds = number("startup-spread", "", s.startupSpreadSeconds);
+    s.tokenTtlSeconds = number("token-ttl", "", s.tokenTtlSeconds);
+    s.tokenMaxTtlSeconds = number("token-max-ttl", "", s.tokenMaxTtlSeconds);
+    s.requestLatencyMs = number("latency-ms", "", s.requestLatencyMs);
+    s.vaultCapacityQps = number("vault-capacity-qps", "", s.vaultCapacityQps);
+    s.restartAtSeconds = number("restart-at", "", s.restartAtSeconds);
+    s.restartDowntimeSeconds = number("restart-downtime", "", s.restartDowntimeSeconds);
+    s.restartRevokesTokens = number("restart-revokes-tokens", "", s.restartRevokesTokens ? 1 : 0) != 0;
+    s.secretUpdateEverySeconds = number("secret-update-every", "", s.secretUpdateEverySeconds);
+    s.threads = std::max(1L, static_cast<long>(number("threads", "", s.threads)));
+    s.reportEverySeconds = std::max(1.0, number("report-every", "", s.reportEverySeconds));
+    s.seed = static_cast<unsigned long>(number("seed", "", s.seed));
+    if (args.count("csv")) s.csvFile = args["csv"];
+
+    if (s.clients < 1 || s.paths < 1 || s.intervalSeconds <= 0 || s.durationSeconds <= 0)
+        throw std::runtime_error("clients/paths/interval/duration 은 0보다 커야 합니다.");
+    return s;
+}
+
+// =========================================================
+// Mock Vault
+// =========================================================
+// 상태는 시각만으로 결정되므로(재시작 구간, Secret 버전) 스레드 간 순서와 무관하게
+// 응답할 수 있습니다. 요청 수는 100ms 버킷별 원자적 카운터로 집계합니다.
+enum class RequestType { Login, LookupSelf, Renew, KvRead, Count };
+
+struct Response {
+    long httpCode = 0;
+    double leaseSeconds = 0;
+    long secretVersion = 0;
+};
+
+class MockVault {
+public:
+    static constexpr double BUCKET_SECONDS = 0.1;
+    static constexpr int TYPES = static_cast<int>(RequestType::Count);
+
+private:
+    const SimSettings& settings;
+    const size_t bucketCount;
+    std::vector<std::atomic<uint32_t>> requests;   // [bucket * TYPES + type]
+    std::vector<std::atomic<uint32_t>> throttled;  // 429
+    std::vector<std::atomic<uint32_t>> unavailable; // 503
+
+    bool isDown(double t) const {
+        return settings.restartAtSeconds >= 0 && t >= settings.restartAtSeconds &&
+               t < settings.restartAtSeconds + settings.restartDowntimeSeconds;
+    }
+
+public:
+    explicit MockVault(const SimSettings& s)
+        : settings(s), bucketCount(static_cast<size_t>(std::ceil(s.durationSeconds / BUCKET_SECONDS)) + 1),
+          requests(bucketCount * TYPES), throttled(bucketCount), unavailable(bucketCount) {}
+
+    size_t buckets() const { return bucketCount; }
+
+    size_t bucketOf(double t) const {
+        return std::min(bucketCount - 1, static_cast<size_t>(std::max(0.0, t) / BUCKET_SECONDS));
+    }
+
+    // 재시작 횟수 (토큰 무효화 판단용)
+    int epochAt(double t) const {
+        if (!settings.restartRevokesTokens || settings.restartAtSeconds < 0) return 0;
+        return t >= settings.restartAtSeconds ? 1 : 0;
+    }
+
+    long secretVersionAt(double t) const {
+        if (settings.secretUpdateEverySeconds <= 0) return 1;
+        return 1 + static_cast<long>(t / settings.secretUpdateEverySeconds);
+    }
+
+    double secretUpdateTime(long version) const {
+        return (version - 1) * settings.secretUpdateEverySeconds;
+    }
+
+    Response handle(RequestType type, double t, int tokenEpoch, double tokenIssuedAt, double tokenExpiry) {
+        const auto bucket = bucketOf(t);
+        const auto count = requests[bucket * TYPES + static_cast<int>(type)].fetch_add(1, std::memory_order_relaxed);
+
+        Response r;
+        if (isDown(t)) {
+            unavailable[bucket].fetch_add(1, std::memory_order_relaxed);
+            r.httpCode = 503;
+            return r;
+        }
+
+        if (settings.vaultCapacityQps > 0) {
+            uint32_t total = count;
+            for (int i = 0; i < TYPES; ++i)
+                if (i != static_cast<int>(type)) total += requests[bucket * TYPES + i].load(std::memory_order_relaxed);
+            if (total > settings.vaultCapacityQps * BUCKET_SECONDS) {
+                throttled[bucket].fetch_add(1, std::memory_order_relaxed);
+                r.httpCode = 429;
+                return r;
+            }
+        }
+
+        if (type == RequestType::Login) {
+            r.httpCode = 200;
+            r.leaseSeconds = std::min(settings.tokenTtlSeconds, settings.tokenMaxTtlSeconds);
+            return r;
+        }
+
+        const bool tokenValid = tokenEpoch == epochAt(t) && t < tokenExpiry;
+        if (!tokenValid) {
+            r.httpCode = 403;
+            return r;
+        }
+
+        r.httpCode = 200;
+        if (type == RequestType::Renew)
+            r.leaseSeconds = std::max(0.0, std::min(t + settings.tokenTtlSeconds, tokenIssuedAt + settings.tokenMaxTtlSeconds) - t);
+        else if (type == RequestType::KvRead)
+            r.secretVersion = secretVersionAt(t);
+        return r;
+    }
+
+    uint32_t requestCount(size_t bucket, RequestType type) const {
+        return requests[bucket * TYPES + static_cast<int>(type)].load(std::memory_order_relaxed);
+    }
+
+    uint32_t totalCount(size_t bucket) const {
+        uint32_t total = 0;
+        for (int i = 0; i < TYPES; ++i) total += requests[bucket * TYPES + i].load(std::memory_order_relaxed);
+        return total;
+    }
+
+    uint32_t throttledCount(size_t bucket) const { return throttled[bucket].load(std::memory_order_relaxed); }
+    uint32_t unavailableCount(size_t bucket) const { return unavailable[bucket].load(std::memory_order_relaxed); }
+};
+
+// =========================================================
+// Simulated Client
+// =========================================================
+// VaultClient 한 프로세스를 상태 머신으로 모델링합니다.
+// 토큰 매니저와 Secret 갱신 루프의 다음 이벤트 시각 중 빠른 쪽을 처리합니다.
+class SimClient {
+private:
+    struct PathState {
+        double nextAttempt = 0;
+        double backoffPrevMs = 0;
+        long seenVersion = 0;
+        bool awaitingToken = false;  // 토큰이 없어 건너뜀 → 재로그인 직후 다시 조회
+    };
+
+    const SimSettings& settings;
+    MockVault& vault;
+    std::mt19937 rng;
+
+    // 토큰
+    bool hasToken = false;
+    int tokenEpoch = 0;
+    double tokenIssuedAt = 0;
+    double tokenExpiry = 0;
+    double leaseStart = 0;
+    double leaseSeconds = 0;
+    double loginLeaseSeconds = 0;
+    bool loginRequired = true;
+    double tokenBackoffPrevMs = 0;
+    // 403 후 토큰 확인 요청 시각 (-1: 없음). 토큰 매니저가 즉시 깨어나 토큰당 한 번만 lookup-self
+    double confirmAt = -1;
+    bool tokenDead = false;  // lookup-self 로 무효 확인됨 → 재로그인 성공 전까지 조회 생략
+
+    // 속도 제한 (Token Bucket)
+    double bucketTokens;
+    double bucketUpdatedAt = 0;
+
+    // 서킷 브레이커
+    long consecutiveFailures = 0;
+    double breakerOpenUntil = -1;
+
+    double nextCycle;
+    double nextTokenAction;
+    std::vector<PathState> paths;
+
+public:
+    // 재시작 이후 첫 로그인 성공 시각 (-1: 아직 없음)
+    double reauthAfterRestartAt = -1;
+    std::vector<double>* propagationLatencies = nullptr;
+
+    SimClient(const SimSettings& s, MockVault& v, unsigned long seed, double startAt)
+        : settings(s), vault(v), rng(seed), bucketTokens(s.rateLimitBurst), nextCycle(startAt),
+          nextTokenAction(startAt), paths(static_cast<size_t>(s.paths)) {}
+
+    double nextEventTime() const { return std::min(nextCycle, tokenDueTime()); }
+
+    void step() {
+        const double tokenDue = tokenDueTime();
+        if (tokenDue <= nextCycle)
+            runTokenAction(tokenDue);
+        else
+            runCycle(nextCycle);
+    }
+
+private:
+    double latency() const { return settings.requestLatencyMs / 1000.0; }
+
+    double tokenDueTime() const { return confirmAt >= 0 ? std::min(confirmAt, nextTokenAction) : nextTokenAction; }
+
+    // VaultClient 의 hasUsableToken: 미인증, 403 확인 대기, 무효 확인 후 재인증 대기 중이면 조회 생략
+    bool hasUsableToken() const { return hasToken && confirmAt < 0 && !tokenDead; }
+
+    double jitterBackoff(double& previousMs) {
+        const double base = std::max(1.0, settings.backoffBaseMs);
+        const double cap = std::max(base, settings.backoffMaxMs);
+        const double upper = std::max(base, (previousMs <= 0 ? base : previousMs) * 3);
+        std::uniform_real_distribution<double> dist(base, upper);
+        previousMs = std::min(cap, dist(rng));
+        return previousMs / 1000.0;
+    }
+
+    static bool isRetryable(long httpCode) {
+        return httpCode == 0 || httpCode == 429 || httpCode >= 500;
+    }
+
+    // 속도 제한/서킷 브레이커를 거쳐 요청. t 는 요청 가능 시각으로 갱신되고 완료 시각을 반환
+    Response send(RequestType type, double& t) {
+        Response r;
+        if (breakerOpenUntil > t) return r;  // 서킷 OPEN: 요청 생략 (httpCode 0)
+
+        if (settings.rateLimitRequestsPerSecond > 0) {
+            bucketTokens = std::min(settings.rateLimitBurst,
+                                    bucketTokens + (t - bucketUpdatedAt) * settings.rateLimitRequestsPerSecond);
+            bucketUpdatedAt = t;
+            if (bucketTokens < 1.0) {
+                t += (1.0 - bucketTokens) / settings.rateLimitRequestsPerSecond;
+                bucketTokens = 1.0;
+                bucketUpdatedAt = t;
+            }
+            bucketTokens -= 1.0;
+        }
+
+        r = vault.handle(type, t, tokenEpoch, tokenIssuedAt, tokenExpiry);
+        t += latency();
+
+        if (isRetryable(r.httpCode)) {
+            if (breakerOpenUntil >= 0 || ++consecutiveFailures >= settings.breakerFailureThreshold) {
+                breakerOpenUntil = t + settings.breakerOpenSeconds;
+                consecutiveFailures = 0;
+            }
+        } else {
+            consecutiveFailures = 0;
+            breakerOpenUntil = -1;
+        }
+        return r;
+    }
+
+    void scheduleTokenAction() {
+        loginRequired = leaseSeconds < loginLeaseSeconds;
+        nextTokenAction = leaseStart + leaseSeconds * (1.0 - settings.renewalThresholdPercent / 100.0);
+    }
+
+    // 로그인 → lookup-self 검증 → 토큰 교체
+    bool login(double& t) {
+        const auto r = send(RequestType::Login, t);
+        if (r.httpCode != 200) return false;
+
+        // 새 토큰을 lookup-self 로 검증, 실패하면 기존 토큰 유지
+        const int oldEpoch = tokenEpoch;
+        const double oldIssuedAt = tokenIssuedAt, oldExpiry = tokenExpiry;
+        const double issuedAt = t;
+        tokenEpoch = vault.epochAt(t);
+        tokenIssuedAt = issuedAt;
+        tokenExpiry = issuedAt + r.leaseSeconds;
+        if (send(RequestType::LookupSelf, t).httpCode != 200) {
+            tokenEpoch = oldEpoch;
+            tokenIssuedAt = oldIssuedAt;
+            tokenExpiry = oldExpiry;
+            return false;
+        }
+
+        hasToken = true;
+        leaseStart = issuedAt;
+        leaseSeconds = r.leaseSeconds;
+        loginLeaseSeconds = r.leaseSeconds;
+        if (settings.restartAtSeconds >= 0 && issuedAt >= settings.restartAtSeconds && reauthAfterRestartAt < 0)
+            reauthAfterRestartAt = t;
+        return true;
+    }
+
+    void runTokenAction(double t) {
+        // 403 확인 요청: 토큰이 무효일 때만 재로그인, 유효하거나 확인 실패면 예정된 작업 유지
+        if (confirmAt >= 0) {
+            confirmAt = -1;
+            if (send(RequestType::LookupSelf, t).httpCode != 403) return;
+            tokenDead = true;
+            loginRequired = true;
+        }
+
+        bool ok;
+        long renewStatus = 0;
+        const bool wasLogin = loginRequired || !hasToken;
+        if (wasLogin) {
+            ok = login(t);
+        } else {
+            const auto r = send(RequestType::Renew, t);
+            renewStatus = r.httpCode;
+            ok = r.httpCode == 200;
+            if (ok) {
+                leaseStart = t;
+                leaseSeconds = r.leaseSeconds;
+                tokenExpiry = t + r.leaseSeconds;
+            }
+        }
+
+        if (ok) {
+            tokenBackoffPrevMs = 0;
+            scheduleTokenAction();
+            if (wasLogin) {
+                // 토큰 교체 → 갱신 루프가 깨어나 건너뛴 경로만 바로 다시 조회
+                tokenDead = false;
+                for (auto& path : paths)
+                    if (path.awaitingToken) readPath(path, t);
+            }
+        } else {
+            // 갱신 실패는 403 이거나 재시도 전에 만료될 때만 재로그인, 그 외에는 renew-self 재시도
+            const double delay = jitterBackoff(tokenBackoffPrevMs);
+            if (wasLogin || renewStatus == 403 || tokenExpiry - t <= delay) loginRequired = true;
+            nextTokenAction = t + delay;
+        }
+    }
+
+    void readPath(PathState& path, double& t) {
+        path.awaitingToken = false;
+        const auto r = send(RequestType::KvRead, t);
+        if (r.httpCode == 403) {
+            // 토큰 확인은 토큰 매니저에 맡기고 (토큰당 한 번) 나머지 경로는 토큰 교체 후 조회
+            if (confirmAt < 0 && !tokenDead) confirmAt = t;
+            path.awaitingToken = true;
+            return;
+        }
+
+        if (r.httpCode == 200) {
+            path.backoffPrevMs = 0;
+            if (r.secretVersion > path.seenVersion) {
+                if (path.seenVersion > 0 && propagationLatencies)
+                    propagationLatencies->push_back(t - vault.secretUpdateTime(r.secretVersion));
+                path.seenVersion = r.secretVersion;
+            }
+        } else if (isRetryable(r.httpCode)) {
+            path.nextAttempt = t + jitterBackoff(path.backoffPrevMs);
+        }
+    }
+
+    void runCycle(double t) {
+        if (!hasToken) {
+            // 최초 인증 전에는 Secret 조회를 하지 않음 (토큰 매니저가 먼저 실행됨)
+            nextCycle = std::max(t, nextTokenAction) + latency();
+            return;
+        }
+
+        for (auto& path : paths) {
+            if (!hasUsableToken()) {
+                path.awaitingToken = true;
+                continue;
+            }
+            if (t < path.nextAttempt) continue;
+            readPath(path, t);
+        }
+
+        nextCycle = t + settings.intervalSeconds;
+    }
+};
+
+// =========================================================
+// Thread Pool Runner
+// =========================================================
+// 클라이언트를 스레드 수만큼 나누고, 100ms 가상 시간 구간마다 모든 스레드가 맞춰
+// 진행합니다 (Vault 용량 초과 판단이 같은 구간의 요청량을 보도록).
+class SliceBarrier {
+private:
+    std::mutex mutex;
+    std::condition_variable released;
+    const long parties;
+    long waiting = 0;
+    unsigned long generation = 0;
+
+public:
+    explicit SliceBarrier(long count) : parties(count) {}
+
+    void arriveAndWait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        const auto gen = generation;
+        if (++waiting == parties) {
+            waiting = 0;
+            ++generation;
+            released.notify_all();
+            return;
+        }
+        released.wait(lock, [&] { return generation != gen; });
+    }
+};
+
+static double percentile(std::vector<double>& values, double p) {
+    if (values.empty()) return 0;
+    const auto idx = static_cast<size_t>(std::min<double>(values.size() - 1, std::floor(p / 100.0 * values.size())));
+    std::nth_element(values.begin(), values.begin() + idx, values.end());
+    return values[idx];
+}
+
+// =========================================================
+// main()
+// =========================================================
+int main(int argc, char* argv[]) {
+    SimSettings settings;
+    try {
+        settings = parseSettings(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "❌ 시뮬레이터 설정 오류: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "🧪 Vault 부하 시뮬레이션: 클라이언트=" << settings.clients << ", 경로=" << settings.paths
+              << ", Interval=" << settings.intervalSeconds << "s, 기간=" << settings.durationSeconds
+              << "s, 스레드=" << settings.threads << std::endl;
+
+    MockVault vault(settings);
+    std::mt19937 seeder(settings.seed);
+    std::uniform_real_distribution<double> startDist(0.0, std::max(0.0, settings.startupSpreadSeconds));
+
+    std::vector<SimClient> clients;
+    clients.reserve(static_cast<size_t>(settings.clients));
+    for (long i = 0; i < settings.clients; ++i)
+        clients.emplace_back(settings, vault, seeder(), startDist(seeder));
+
+    const long threadCount = std::min(settings.threads, settings.clients);
+    std::vector<std::vector<double>> latencies(static_cast<size_t>(threadCount));
+    SliceBarrier barrier(threadCount);
+
+    const auto wallStart = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (long w = 0; w < threadCount; ++w) {
+        workers.emplace_back([&, w] {
+            const size_t begin = clients.size() * w / threadCount;
+            const size_t end = clients.size() * (w + 1) / threadCount;
+            for (size_t i = begin; i < end; ++i) clients[i].propagationLatencies = &latencies[w];
+
+            for (size_t slice = 1; slice <= vault.buckets(); ++slice) {
+                const double sliceEnd = std::min(settings.durationSeconds, slice * MockVault::BUCKET_SECONDS);
+                for (size_t i = begin; i < end; ++i)
+                    while (clients[i].nextEventTime() < sliceEnd) clients[i].step();
+                barrier.arriveAndWait();
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    const auto wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+    // -------------------------------------------------------------
+    // 결과 집계: 초 단위 타임라인 + 요약
+    // -------------------------------------------------------------
+    const size_t bucketsPerSecond = static_cast<size_t>(std::lround(1.0 / MockVault::BUCKET_SECONDS));
+    const size_t seconds = static_cast<size_t>(std::ceil(settings.durationSeconds));
+    struct SecondStats { uint32_t total = 0, login = 0, lookup = 0, renew = 0, kv = 0, throttled = 0, unavailable = 0; };
+    std::vector<SecondStats> timeline(seconds);
+    uint32_t peakBurst = 0;
+    double peakBurstAt = 0;
+
+    for (size_t b = 0; b < vault.buckets(); ++b) {
+        const size_t sec = std::min(seconds - 1, b / bucketsPerSecond);
+        auto& st = timeline[sec];
+        st.login += vault.requestCount(b, RequestType::Login);
+        st.lookup += vault.requestCount(b, RequestType::LookupSelf);
+        st.renew += vault.requestCount(b, RequestType::Renew);
+        st.kv += vault.requestCount(b, RequestType::KvRead);
+        st.throttled += vault.throttledCount(b);
+        st.unavailable += vault.unavailableCount(b);
+        const auto total = vault.totalCount(b);
+        st.total += total;
+        if (total > peakBurst) {
+            peakBurst = total;
+            peakBurstAt = b * MockVault::BUCKET_SECONDS;
+        }
+    }
+
+    std::ofstream csv;
+    if (!settings.csvFile.empty()) {
+        csv.open(settings.csvFile);
+        csv << "second,total,login,lookup_self,renew,kv_read,throttled_429,unavailable_503\n";
+        for (size_t sec = 0; sec < seconds; ++sec) {
+            const auto& st = timeline[sec];
+            csv << sec << ',' << st.total << ',' << st.login << ',' << st.lookup << ',' << st.renew << ','
+                << st.kv << ',' << st.throttled << ',' << st.unavailable << '\n';
+        }
+    }
+
+    std::cout << "\n📈 [QPS 타임라인] (구간 평균 / 구간 내 최대 1초 QPS)" << std::endl;
+    std::cout << std::setw(8) << "t(s)" << std::setw(10) << "avg" << std::setw(10) << "peak"
+              << std::setw(9) << "login" << std::setw(9) << "lookup" << std::setw(9) << "renew" << std::setw(10) << "kv"
+              << std::setw(8) << "429" << std::setw(8) << "503" << std::endl;
+    const size_t window = static_cast<size_t>(settings.reportEverySeconds);
+    uint64_t grandTotal = 0;
+    uint32_t peakSecond = 0;
+    size_t peakSecondAt = 0;
+    for (size_t start = 0; start < seconds; start += window) {
+        SecondStats sum;
+        uint32_t peak = 0;
+        const size_t end = std::min(seconds, start + window);
+        for (size_t sec = start; sec < end; ++sec) {
+            const auto& st = timeline[sec];
+            sum.total += st.total; sum.login += st.login; sum.lookup += st.lookup; sum.renew += st.renew; sum.kv += st.kv;
+            sum.throttled += st.throttled; sum.unavailable += st.unavailable;
+            peak = std::max(peak, st.total);
+            if (st.total > peakSecond) { peakSecond = st.total; peakSecondAt = sec; }
+        }
+        grandTotal += sum.total;
+        std::cout << std::setw(8) << start << std::setw(10) << std::fixed << std::setprecision(1)
+                  << static_cast<double>(sum.total) / (end - start) << std::setw(10) << peak
+                  << std::setw(9) << sum.login << std::setw(9) << sum.lookup << std::setw(9) << sum.renew << std::setw(10) << sum.kv
+                  << std::setw(8) << sum.throttled << std::setw(8) << sum.unavailable << std::endl;
+    }
+
+    std::cout << "\n📋 [요약]" << std::endl;
+    std::cout << "  평균 QPS: " << static_cast<double>(grandTotal) / settings.durationSeconds << std::endl;
+    std::cout << "  최대 1초 QPS: " << peakSecond << " (t=" << peakSecondAt << "s)" << std::endl;
+    std::cout << "  최대 버스트: " << peakBurst << "건/100ms (≈" << peakBurst * bucketsPerSecond
+              << " QPS, t=" << peakBurstAt << "s)" << std::endl;
+
+    if (settings.restartAtSeconds >= 0) {
+        std::vector<double> reauth;
+        for (const auto& c : clients)
+            if (c.reauthAfterRestartAt >= 0)
+                reauth.push_back(c.reauthAfterRestartAt - (settings.restartAtSeconds + settings.restartDowntimeSeconds));
+        uint32_t peakLogin = 0;
+        uint64_t loginsAfter = 0;
+        for (size_t sec = static_cast<size_t>(settings.restartAtSeconds); sec < seconds; ++sec) {
+            peakLogin = std::max(peakLogin, timeline[sec].login);
+            loginsAfter += timeline[sec].login;
+        }
+        std::cout << "  Vault 재시작(t=" << settings.restartAtSeconds << "s, 중단 " << settings.restartDowntimeSeconds
+                  << "s) 이후 로그인: 총 " << loginsAfter << "건, 최대 " << peakLogin << "건/s" << std::endl;
+        std::cout << "  재인증 완료 클라이언트: " << reauth.size() << "/" << clients.size();
+        if (!reauth.empty()) {
+            std::cout << " (복구 후 소요 p50=" << percentile(reauth, 50) << "s, p99=" << percentile(reauth, 99)
+                      << "s, max=" << *std::max_element(reauth.begin(), reauth.end()) << "s)";
+        }
+        std::cout << std::endl;
+    }
+
+    std::vector<double> propagation;
+    for (auto& l : latencies) propagation.insert(propagation.end(), l.begin(), l.end());
+    if (!propagation.empty()) {
+        const double maxLatency = *std::max_element(propagation.begin(), propagation.end());
+        std::cout << "  Secret 전파 지연 (" << propagation.size() << "건): p50=" << percentile(propagation, 50)
+                  << "s, p90=" << percentile(propagation, 90) << "s, p99=" << percentile(propagation, 99)
+                  << "s, max=" << maxLatency << "s" << std::endl;
+    }
+
+    std::cout << "  시뮬레이션 실행 시간: " << wallSeconds << "s" << std::endl;
+    if (!settings.csvFile.empty())
+        std::cout << "  초 단위 타임라인 CSV: " << settings.csvFile << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,216 @@
+// =========================================================
+// 정상 상태(steady-state) C++ 힙 할당 테스트
+// =========================================================
+// 데이터가 바뀌지 않은 KV 갱신 주기(refreshSecrets + renderSecrets)에서 클라이언트 C++ 코드가
+// operator new 를 한 번이라도 호출하면 실패합니다. 외부 Vault 없이 프로세스 내
+// Mock Vault(HTTP/1.1 keep-alive)를 띄우고, 테스트 스레드에서 발생한 할당만 셉니다.
+// libcurl 내부 malloc 은 curl_global_init_mem 으로 따로 세어 보고만 합니다 (실패 조건 아님).
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <thread>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// 교체한 operator delete 가 free 를 호출하므로 GCC 11+ 의 new/delete 짝 경고는 이 파일에서 끔
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+static std::atomic<long> g_allocations{0};
+static std::atomic<long> g_curlAllocations{0};
+static thread_local bool t_countAllocations = false;
+
+void* operator new(std::size_t size) {
+    if (t_countAllocations) g_allocations++;
+    void* p = std::malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+// libcurl 메모리 콜백 (curl_global_init_mem)
+static void* curlMalloc(size_t size) {
+    if (t_countAllocations) g_curlAllocations++;
+    return std::malloc(size);
+}
+static void* curlCalloc(size_t count, size_t size) {
+    if (t_countAllocations) g_curlAllocations++;
+    return std::calloc(count, size);
+}
+static void* curlRealloc(void* p, size_t size) {
+    if (t_countAllocations) g_curlAllocations++;
+    return std::realloc(p, size);
+}
+static char* curlStrdup(const char* text) {
+    if (t_countAllocations) g_curlAllocations++;
+    return ::strdup(text);
+}
+static void curlFree(void* p) { std::free(p); }
+
+#define main vaultClientMain
+#include "../src/VaultClient.cpp"
+#undef main
+
+// ---------------------------------------------------------
+// Mock Vault: 로그인, lookup-self, KV 조회(버전 고정)만 응답
+// ---------------------------------------------------------
+class MockVault {
+private:
+    int listenFd = -1;
+    int port = 0;
+    std::thread worker;
+
+    static bool readRequest(int fd, std::string& buffer, std::string& requestLine) {
+        size_t headerEnd;
+        while ((headerEnd = buffer.find("\r\n\r\n")) == std::string::npos) {
+            char chunk[4096];
+            const auto n = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) return false;
+            buffer.append(chunk, static_cast<size_t>(n));
+        }
+
+        size_t contentLength = 0;
+        const auto lengthPos = buffer.find("Content-Length:");
+        if (lengthPos != std::string::npos && lengthPos < headerEnd)
+            contentLength = std::strtoul(buffer.c_str() + lengthPos + 15, nullptr, 10);
+        while (buffer.size() < headerEnd + 4 + contentLength) {
+            char chunk[4096];
+            const auto n = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) return false;
+            buffer.append(chunk, static_cast<size_t>(n));
+        }
+
+        requestLine = buffer.substr(0, buffer.find("\r\n"));
+        buffer.erase(0, headerEnd + 4 + contentLength);
+        return true;
+    }
+
+    static std::string respond(const std::string& requestLine) {
+        std::string body;
+        if (requestLine.find("/v1/auth/approle/login") != std::string::npos)
+            body = R"({"auth":{"client_token":"s.test","lease_duration":3600,"renewable":true}})";
+        else if (requestLine.find("/v1/auth/token/lookup-self") != std::string::npos)
+            body = R"({"data":{"ttl":3600}})";
+        else if (requestLine.find("/data/") != std::string::npos)
+            body = R"({"data":{"data":{"user":"app","password":"secret"},"metadata":{"version":7}}})";
+
+        const auto status = body.empty() ? "404 Not Found" : "200 OK";
+        return std::string("HTTP/1.1 ") + status + "\r\nContent-Type: application/json\r\nContent-Length: " +
+               std::to_string(body.size()) + "\r\n\r\n" + body;
+    }
+
+    void serve() {
+        while (true) {
+            const int fd = ::accept(listenFd, nullptr, nullptr);
+            if (fd < 0) return;
+            std::thread([fd] {
+                std::string buffer;
+                std::string requestLine;
+                while (readRequest(fd, buffer, requestLine)) {
+                    const auto response = respond(requestLine);
+                    if (::send(fd, response.data(), response.size(), MSG_NOSIGNAL) < 0) break;
+                }
+                ::close(fd);
+            }).detach();
+        }
+    }
+
+public:
+    MockVault() {
+        listenFd = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(addr);
+        if (listenFd < 0 || ::bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+            ::listen(listenFd, 16) != 0 || ::getsockname(listenFd, reinterpret_cast<sockaddr*>(&addr), &length) != 0)
+            throw std::runtime_error("Mock Vault 소켓 생성 실패");
+        port = ntohs(addr.sin_port);
+        worker = std::thread(&MockVault::serve, this);
+        worker.detach();
+    }
+
+    int listenPort() const { return port; }
+};
+
+// VaultClient 의 private 갱신 루프를 직접 구동 (VaultClient 에 friend 로 선언됨)
+struct SteadyStateAllocTest {
+    static int run() {
+        MockVault vault;
+        {
+            std::ofstream config("config.properties");
+            config << "vault.vault_addr = http://127.0.0.1:" << vault.listenPort() << "\n"
+                   << "vault.vault_role_id = role\n"
+                   << "vault.vault_secret_id = secret\n"
+                   << "kv_mount_path = kv\n"
+                   << "kv_secrets_paths = application, db, cache\n"
+                   << "kv_renewal_interval_seconds = 1\n"
+                   << "token_renewal_threshold_percent = 20\n"
+                   << "rate_limit_requests_per_second = 0\n"
+                   // 느린 호출 로그만 켠 상태에서도 임계값 미만 호출은 할당이 없어야 함
+                   << "slow_call_log_enabled = 1\n"
+                   << "slow_call_threshold_ms = 60000\n"
+                   // 렌더링 대상도 매 주기 확인 (캐시가 그대로면 다시 렌더링하지 않아야 함)
+                   << "render_targets = app-env\n"
+                   << "render.app-env.format = env\n"
+                   << "render.app-env.paths = application, db\n"
+                   << "render.app-env.destination = steady_state_app.env\n";
+        }
+        std::remove("steady_state_app.env");
+
+        VaultClient client;
+        for (auto& tenant : client.tenants)
+            if (!tenant->tokenManager.start(client.http)) return EXIT_FAILURE;
+
+        // 첫 주기는 캐시/버퍼를 채우고, 두 번째 주기까지 돌려 용량을 안정화
+        client.refreshSecrets();
+        client.renderSecrets();
+        client.refreshSecrets();
+        client.renderSecrets();
+        if (!std::ifstream("steady_state_app.env")) {
+            std::cerr << "❌ 렌더링 파일이 생성되지 않았습니다: steady_state_app.env" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        t_countAllocations = true;
+        for (int cycle = 0; cycle < 5; ++cycle) {
+            client.refreshSecrets();
+            client.renderSecrets();
+        }
+        t_countAllocations = false;
+
+        const long allocations = g_allocations.load();
+        const long curlAllocations = g_curlAllocations.load();
+        const long requests = 5 * static_cast<long>(client.tenants.front()->pathStates.size());
+        std::cout << "\n🧪 정상 상태 갱신 5주기 C++ 힙 할당: " << allocations << "회" << std::endl;
+        std::cout << "ℹ️ libcurl 내부 할당: " << curlAllocations << "회 (요청 " << requests << "건, 요청당 "
+                  << (requests > 0 ? curlAllocations / requests : 0) << "회, 참고용)" << std::endl;
+        return allocations == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+};
+
+int main() {
+    curl_global_init_mem(CURL_GLOBAL_DEFAULT, curlMalloc, curlFree, curlRealloc, curlStrdup, curlCalloc);
+    int exitCode = EXIT_FAILURE;
+    try {
+        exitCode = SteadyStateAllocTest::run();
+    } catch (const std::exception& e) {
+        std::cerr << "❌ 테스트 실행 오류: " << e.what() << std::endl;
+    }
+    curl_global_cleanup();
+    // Mock Vault 스레드는 detach 상태이므로 정리 없이 종료
+    std::_Exit(exitCode);
+}